@@ -0,0 +1,111 @@
+#include "mmap.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+using namespace std;
+
+/*
+ * Times an MMap<string, int> of every node order MIN in ORDERS: KEYS
+ * string keys inserted one at a time in random order, KEYS random
+ * lookups, RANGES range scans of RANGE_KEYS keys each and SCANS full
+ * scans through the iterator. The default order is the one
+ * bplustree_minimum picks for the indices of a table.
+ */
+
+const int KEYS = 300000;
+const int RANGES = 20000;
+const int RANGE_KEYS = 100;
+const int SCANS = 5;
+
+// milliseconds since start
+static long since(chrono::steady_clock::time_point start)
+{
+    return static_cast<long>(chrono::duration_cast<chrono::milliseconds>(
+                                 chrono::steady_clock::now() - start)
+                                 .count());
+}
+
+// the keys of a column of last names, all of the same length so they
+// sort like their numbers
+static vector<string> make_keys()
+{
+    vector<string> keys;
+    keys.reserve(KEYS);
+    char key[16];
+    for (int i = 0; i < KEYS; ++i)
+    {
+        snprintf(key, sizeof(key), "name%07d", i);
+        keys.push_back(key);
+    }
+    return keys;
+}
+
+template <int MIN>
+static void run(const vector<string> &keys, const vector<int> &order,
+                bool isDefault)
+{
+    MMap<string, int, MIN> index;
+    long found = 0;
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    // the way a table adds a record to a column index
+    for (int i = 0; i < KEYS; ++i)
+        index[keys[order[i]]] += order[i];
+    long insert = since(start);
+
+    start = chrono::steady_clock::now();
+    for (int i = KEYS - 1; i >= 0; --i)
+        found += index.contains(keys[order[i]]);
+    long lookup = since(start);
+
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < RANGES; ++i)
+    {
+        int low = order[i] % (KEYS - RANGE_KEYS);
+        typename MMap<string, int, MIN>::Iterator it =
+            index.lower_bound(keys[low]);
+        typename MMap<string, int, MIN>::Iterator end =
+            index.upper_bound(keys[low + RANGE_KEYS - 1]);
+        for (; it != end; ++it)
+            found += it->value_list.size();
+    }
+    long range = since(start);
+
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < SCANS; ++i)
+        for (typename MMap<string, int, MIN>::Iterator it = index.begin();
+             it != index.end(); ++it)
+            found += it->value_list.size();
+    long scan = since(start);
+
+    // found keeps the loops from being optimized away
+    printf("%5d %8ld ms %8ld ms %8ld ms %8ld ms %s\n", MIN, insert, lookup,
+           range, scan, isDefault ? "  (default)" : "");
+    if (found != KEYS + static_cast<long>(RANGES) * RANGE_KEYS +
+                     static_cast<long>(SCANS) * KEYS)
+        printf("wrong count: %ld\n", found);
+}
+
+int main()
+{
+    vector<string> keys = make_keys();
+    vector<int> order(KEYS);
+    for (int i = 0; i < KEYS; ++i)
+        order[i] = i;
+    shuffle(order.begin(), order.end(), mt19937(42));
+
+    const int DEFAULT = bplustree_minimum<MPair<string, int>>();
+    printf("%d keys, %d lookups, %d range scans of %d keys, %d full scans\n\n",
+           KEYS, KEYS, RANGES, RANGE_KEYS, SCANS);
+    printf("%5s %11s %11s %11s %11s\n", "MIN", "insert", "lookup", "range",
+           "scan");
+    run<1>(keys, order, DEFAULT == 1);
+    run<2>(keys, order, DEFAULT == 2);
+    run<4>(keys, order, DEFAULT == 4);
+    run<8>(keys, order, DEFAULT == 8);
+    run<16>(keys, order, DEFAULT == 16);
+    run<bplustree_minimum<MPair<string, int>>()>(keys, order, true);
+    run<64>(keys, order, DEFAULT == 64);
+    return 0;
+}
@@ -8,11 +8,26 @@ export interface TXT2DBModule extends EmscriptenModule {
   cleanup: () => void
 }
 
+// One step of an explain plan, with the inputs it pulled from
+export interface PlanStep {
+  step: string
+  rows_planned: number
+  rows_in: number
+  rows_out: number
+  estimate: number
+  records: number
+  bytes: number
+  ms: number
+  inputs: PlanStep[]
+}
+
 export interface QueryResult {
-  type?: "create" | "insert" | "select"
+  type?: "create" | "insert" | "select" | "analyze" | "explain" | "set"
   table?: string
   message?: string
   output?: string
+  analyze?: boolean
+  plan?: PlanStep
   error?: string
 }
 
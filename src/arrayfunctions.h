@@ -132,16 +132,20 @@ void Swap(T &a, T &b)
 template <class T>
 int first_ge(const T data[], int n, const T &entry)
 {
-    // go through data
-    for (int i = 0; i < n; ++i)
+    // data is sorted, so binary search for it. if there is no data
+    // larger than entry this returns the size, indicating that all
+    // entries are less than the target
+    int lo = 0;
+    int hi = n;
+    while (lo < hi)
     {
-        if (data[i] >= entry)
-            return i;
+        int mid = lo + (hi - lo) / 2;
+        if (data[mid] < entry)
+            lo = mid + 1;
+        else
+            hi = mid;
     }
-    // if there is no data larger than entry
-    // return the size, indicating that all entries
-    // are less than the target
-    return n;
+    return lo;
 }
 
 // Postcondition: insert entry at index i in data
@@ -153,24 +157,24 @@ void insert_item(T data[], int i, int &n, T entry)
     // shift over existing entries
     for (int j = n - 1; j > i; --j)
     {
-        data[j] = data[j - 1];
+        data[j] = std::move(data[j - 1]);
     }
     // place entry
-    data[i] = entry;
+    data[i] = std::move(entry);
 }
 
 template <class T>
 void delete_item(T data[], int i, int &n, T &entry)
 {
     // place item at index i at entry
-    entry = data[i];
+    entry = std::move(data[i]);
 
     for (int j = i + 1; j < n; j++)
     {
-        data[j - 1] = data[j];
+        data[j - 1] = std::move(data[j]);
     }
-    // set final element to 0
-    data[n - 1] = 0;
+    // reset the final element
+    data[n - 1] = T();
     n--;
 
     bool debug = false;
@@ -199,7 +203,7 @@ void merge(T data1[], int &n1, T data2[], int &n2)
 {
     for (int i = 0; i < n2; ++i)
     {
-        data1[n1] = data2[i];
+        data1[n1] = std::move(data2[i]);
         n1++;
     }
     n2 = 0;
@@ -210,7 +214,7 @@ void merge(T data1[], int &n1, T data2[], int &n2)
 template <class T>
 void detach_item(T data[], int &n, T &entry)
 {
-    entry = data[n - 1];
+    entry = std::move(data[n - 1]);
     --n;
 }
 
@@ -249,13 +253,16 @@ void ordered_insert(T data[], int &n, T entry)
 template <class T>
 void split(T data1[], int &n1, T data2[], int &n2)
 {
-    T trash;
     int half = n1 / 2;
+
+    // make room at the front of data2, then move the last half of
+    // data1 there in one pass
+    for (int i = n2 - 1; i >= 0; --i)
+        data2[i + half] = std::move(data2[i]);
     for (int i = 0; i < half; ++i)
-    {
-        detach_item(data1, n1, trash);
-        insert_item(data2, 0, n2, trash);
-    }
+        data2[i] = std::move(data1[n1 - half + i]);
+    n1 -= half;
+    n2 += half;
 
     bool debug = false;
     if (debug)
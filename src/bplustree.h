@@ -3,9 +3,28 @@
 
 #include "mylib.h"
 #include "arrayfunctions.h"
+#include "node_pool.h"
+#include <type_traits>
 using namespace std;
 
+// bytes the keys and child pointers of a full node should fit in. one
+// node is then about a page of memory, and a lookup touches a handful
+// of nodes instead of one per level of a binary tree
+const int BPLUSTREE_NODE_BYTES = 4096;
+
+// default MINIMUM for a tree of T: the largest that keeps a full node
+// (MAXIMUM + 1 keys, MAXIMUM + 2 children) within BPLUSTREE_NODE_BYTES
 template <class T>
+constexpr int bplustree_minimum()
+{
+    return BPLUSTREE_NODE_BYTES / int(sizeof(T) + sizeof(void *)) / 2 > 1
+               ? BPLUSTREE_NODE_BYTES / int(sizeof(T) + sizeof(void *)) / 2
+               : 1;
+}
+
+// MIN is the fewest keys a node other than the root holds, a node
+// holds at most 2 * MIN keys
+template <class T, int MIN = bplustree_minimum<T>()>
 class BPlusTree
 {
 public:
@@ -20,11 +39,12 @@ public:
     public:
         friend class BPlusTree;
 
-        Iterator(BPlusTree<T> *_it = NULL, int _key_ptr = 0)
+        Iterator(BPlusTree *_it = NULL, int _key_ptr = 0)
             : it(_it), key_ptr(_key_ptr) {}
 
-        // overloaded dereference operator
-        T operator*()
+        // overloaded dereference operator. returns the entry itself,
+        // not a copy of it
+        const T &operator*() const
         {
 
             assert(key_ptr < it->data_count);
@@ -33,6 +53,12 @@ public:
             return it->data[key_ptr];
         }
 
+        // overloaded member access operator
+        const T *operator->() const
+        {
+            return &**this;
+        }
+
         // overloaded incrementation operator
         Iterator operator++(int un_used)
         {
@@ -105,7 +131,102 @@ public:
         bool is_null() { return !it; }
 
     private:
-        BPlusTree<T> *it;
+        BPlusTree *it;
+        int key_ptr;
+    };
+
+    // This iterator goes through the childless nodes from the
+    // largest entry to the smallest. leaves only link forward, so it
+    // keeps the path from the root to its leaf and climbs back up it
+    // to reach the leaf before
+    class ReverseIterator
+    {
+    public:
+        friend class BPlusTree;
+
+        ReverseIterator() : leaf(NULL), key_ptr(0) {}
+
+        // overloaded dereference operator
+        const T &operator*() const
+        {
+            assert(leaf && key_ptr < leaf->data_count);
+            return leaf->data[key_ptr];
+        }
+
+        // overloaded member access operator
+        const T *operator->() const
+        {
+            return &**this;
+        }
+
+        // overloaded incrementation operator, moves to the entry
+        // before this one
+        ReverseIterator operator++()
+        {
+            if (key_ptr > 0)
+                key_ptr--;
+            else
+                previous_leaf();
+            return *this;
+        }
+
+        // overloaded incrementation operator
+        ReverseIterator operator++(int un_used)
+        {
+            (void)un_used;
+            ReverseIterator temp = *this;
+            ++*this;
+            return temp;
+        }
+
+        friend bool operator==(const ReverseIterator &lhs,
+                               const ReverseIterator &rhs)
+        {
+            return lhs.leaf == rhs.leaf && lhs.key_ptr == rhs.key_ptr;
+        }
+
+        friend bool operator!=(const ReverseIterator &lhs,
+                               const ReverseIterator &rhs)
+        {
+            return !(lhs == rhs);
+        }
+
+    private:
+        // goes down the rightmost children of node to its last entry
+        void descend(BPlusTree *node)
+        {
+            while (!node->is_leaf())
+            {
+                path.push_back(make_pair(node, node->child_count - 1));
+                node = node->subset[node->child_count - 1];
+            }
+            leaf = node;
+            key_ptr = node->data_count - 1;
+            // an empty leaf (only the root can be one) has no entries
+            if (key_ptr < 0)
+                previous_leaf();
+        }
+
+        // climbs to the closest ancestor with a child left of the path
+        // and goes down that child. NULL leaf once there is none
+        void previous_leaf()
+        {
+            while (!path.empty() && path.back().second == 0)
+                path.pop_back();
+            if (path.empty())
+            {
+                leaf = NULL;
+                key_ptr = 0;
+                return;
+            }
+            int child = --path.back().second;
+            descend(path.back().first->subset[child]);
+        }
+
+        // the ancestors of leaf and which of their children the path
+        // goes through
+        vector<pair<BPlusTree *, int>> path;
+        BPlusTree *leaf;
         int key_ptr;
     };
 
@@ -120,6 +241,8 @@ public:
         data_count = 0;
         dups_ok = dups;
         next = NULL;
+        pool = NULL;
+        owns_pool = false;
     }
 
     /*
@@ -131,18 +254,24 @@ public:
     ~BPlusTree()
     {
         clear_tree();
+        if (owns_pool)
+            delete pool;
     }
 
-    // Copy constructor
-    BPlusTree(const BPlusTree<T> &other)
+    // Copy constructor. the copy gets nodes from a pool of its own
+    BPlusTree(const BPlusTree &other)
     {
-        // clear tree first
-        clear_tree();
+        child_count = 0;
+        data_count = 0;
+        dups_ok = other.dups_ok;
+        next = NULL;
+        pool = NULL;
+        owns_pool = false;
         copy_tree(other);
     }
 
     // overloaded assignment operator
-    BPlusTree<T> &operator=(const BPlusTree<T> &RHS)
+    BPlusTree &operator=(const BPlusTree &RHS)
     {
         if (this != &RHS)
         {
@@ -154,16 +283,49 @@ public:
         return *this; // Return *this for chaining
     }
 
+    // Move constructor. takes the nodes of other instead of copying
+    // them, other is left empty
+    BPlusTree(BPlusTree &&other) noexcept
+    {
+        pool = NULL;
+        owns_pool = false;
+        move_tree(other);
+    }
+
+    // overloaded move assignment operator
+    BPlusTree &operator=(BPlusTree &&RHS) noexcept
+    {
+        if (this != &RHS)
+        {
+            // Clean up the current object and its pool
+            clear_tree();
+            if (owns_pool)
+                delete pool;
+            // Take the nodes of RHS
+            move_tree(RHS);
+        }
+        return *this;
+    }
+
     // postcondition: clears tree, used in destructor
     void clear_tree()
     {
+        if (owns_pool)
+        {
+            // every node below the root is in the pool: destroy their
+            // keys (if they need it) and give back all of the nodes at
+            // once instead of one at a time
+            if (!is_trivially_destructible<T>::value)
+                destroy_children();
+            child_count = 0;
+            pool->reset();
+        }
+
         // go through all children
         for (int i = 0; i < child_count; i++)
         {
-            // recursively call clear tree
-            subset[i]->clear_tree();
-            // delete the child and set it to NULL
-            delete subset[i];
+            // destroying a child clears its own children
+            free_node(subset[i]);
             subset[i] = NULL;
         }
 
@@ -175,16 +337,41 @@ public:
 
     // copy_tree. Used in copy constructor
     // and overloaded assignment operator
-    void copy_tree(const BPlusTree<T> &other)
+    void copy_tree(const BPlusTree &other)
     {
-        BPlusTree<T> *temp = NULL;
+        BPlusTree *temp = NULL;
 
         // we will use temp to keep our leafs linked
         copy_helper(other, temp);
     }
 
+    // move_tree. Used in the move constructor and move assignment.
+    // this must hold no nodes and no pool
+    void move_tree(BPlusTree &other)
+    {
+        // the root's keys live in the root itself and have to be moved
+        // one by one, everything under it just changes hands
+        for (int i = 0; i < other.data_count; ++i)
+            data[i] = std::move(other.data[i]);
+        for (int i = 0; i < other.child_count; ++i)
+            subset[i] = other.subset[i];
+        data_count = other.data_count;
+        child_count = other.child_count;
+        dups_ok = other.dups_ok;
+        next = other.next;
+        pool = other.pool;
+        owns_pool = other.owns_pool;
+
+        // other is now an empty tree without a pool
+        other.data_count = 0;
+        other.child_count = 0;
+        other.next = NULL;
+        other.pool = NULL;
+        other.owns_pool = false;
+    }
+
     // used to keep track of temp pointer that tracks our leafs
-    void copy_helper(const BPlusTree<T> &other, BPlusTree<T> *&temp)
+    void copy_helper(const BPlusTree &other, BPlusTree *&temp)
     {
         // handle the linked leafs
         if (other.is_leaf())
@@ -202,7 +389,7 @@ public:
         // recursively go through children (starting rightmost)
         for (int i = other.child_count - 1; i >= 0; i--)
         {
-            subset[i] = new BPlusTree<T>;
+            subset[i] = make_node();
             subset[i]->copy_helper(*other.subset[i], temp);
         }
     }
@@ -340,7 +527,7 @@ public:
         if (data_count > MAXIMUM)
         {
             // shallow copy this to a temp
-            BPlusTree *temp = new BPlusTree<T>;
+            BPlusTree *temp = make_node();
             temp->shallow_copy(*this);
 
             // shallow clear this
@@ -356,6 +543,85 @@ public:
         }
     }
 
+    // Precondition: entries is sorted and holds no two equal keys
+    // Postcondition: the tree holds exactly entries, which is left
+    // empty. The tree is built bottom up, one level at a time: full
+    // leaves first, then the nodes above them, instead of inserting
+    // and splitting one entry at a time
+    void build(vector<T> &entries)
+    {
+        clear_tree();
+        next = NULL;
+
+        // few enough entries for the root to be the only leaf
+        if (entries.size() <= size_t(MAXIMUM))
+        {
+            for (size_t i = 0; i < entries.size(); ++i)
+                data[i] = std::move(entries[i]);
+            data_count = static_cast<int>(entries.size());
+            entries.clear();
+            return;
+        }
+
+        // spread the entries evenly over as few leaves as possible,
+        // linking each leaf to the next one
+        vector<BPlusTree *> level;
+        size_t n = entries.size();
+        size_t count = (n + MAXIMUM - 1) / MAXIMUM;
+        size_t pos = 0;
+        BPlusTree *prev = NULL;
+        for (size_t k = 0; k < count; ++k)
+        {
+            int take = static_cast<int>(n / count + (k < n % count ? 1 : 0));
+            BPlusTree *leaf = make_node(dups_ok);
+            for (int j = 0; j < take; ++j)
+                leaf->data[j] = std::move(entries[pos++]);
+            leaf->data_count = take;
+            if (prev)
+                prev->next = leaf;
+            prev = leaf;
+            level.push_back(leaf);
+        }
+        entries.clear();
+
+        // group the nodes of a level under parents until they fit
+        // under the root
+        while (level.size() > size_t(MAXIMUM + 1))
+        {
+            vector<BPlusTree *> upper;
+            size_t c = level.size();
+            size_t parents = (c + MAXIMUM) / (MAXIMUM + 1);
+            pos = 0;
+            for (size_t k = 0; k < parents; ++k)
+            {
+                int take = static_cast<int>(c / parents +
+                                            (k < c % parents ? 1 : 0));
+                BPlusTree *node = make_node(dups_ok);
+                node->adopt(&level[pos], take);
+                pos += take;
+                upper.push_back(node);
+            }
+            level.swap(upper);
+        }
+
+        // the root is this node
+        adopt(&level[0], static_cast<int>(level.size()));
+    }
+
+    // Postcondition: moves every entry, in order, to the back of
+    // entries and leaves the tree empty
+    void flatten(vector<T> &entries)
+    {
+        for (BPlusTree *leaf = get_smallest_node(); leaf != NULL;
+             leaf = leaf->next)
+        {
+            for (int i = 0; i < leaf->data_count; ++i)
+                entries.push_back(std::move(leaf->data[i]));
+        }
+        clear_tree();
+        next = NULL;
+    }
+
     /*
      * *************************************************************
      *                      R E M O V E
@@ -371,14 +637,13 @@ public:
             // fix the root of the entire tree so that it no
             // longer has zero entries
             // set a temp pointer that points to the only child
-            BPlusTree *temp = new BPlusTree<T>;
-            temp = subset[0];
+            BPlusTree *temp = subset[0];
 
             // copy all data and subsets to root
             copy_tree(*temp);
 
             // delete original child
-            delete temp;
+            free_node(temp);
         }
     }
     /*
@@ -413,7 +678,7 @@ public:
         }
     }
     friend ostream &operator<<(ostream &outs,
-                               const BPlusTree<T> &print_me)
+                               const BPlusTree &print_me)
     {
         print_me.print_tree(0, outs);
         return outs;
@@ -424,9 +689,12 @@ public:
      *                       I T E R A T O R S
      * *************************************************************
      */
-    // Post: Iterator begins at lowest/leftmost node of tree
+    // Post: Iterator begins at lowest/leftmost node of tree, end() if
+    // the tree is empty (its root is then an empty leaf)
     Iterator begin()
     {
+        if (empty())
+            return end();
         return Iterator(get_smallest_node());
     }
     Iterator end()
@@ -434,6 +702,46 @@ public:
         return Iterator(NULL);
     }
 
+    // Post: ReverseIterator begins at the largest entry of the tree
+    ReverseIterator rbegin()
+    {
+        ReverseIterator it;
+        it.descend(this);
+        return it;
+    }
+    ReverseIterator rend()
+    {
+        return ReverseIterator();
+    }
+
+    // Post: Iterator to the first entry that is not less than entry,
+    // end() if there is none
+    Iterator lower_bound(const T &entry)
+    {
+        int i = first_ge(data, data_count, entry);
+        bool found = (i < data_count && data[i] == entry);
+        if (is_leaf())
+            return leaf_position(i);
+        if (found) // inner node
+            return subset[i + 1]->lower_bound(entry);
+        else
+            return subset[i]->lower_bound(entry);
+    }
+
+    // Post: Iterator to the first entry that is greater than entry,
+    // end() if there is none
+    Iterator upper_bound(const T &entry)
+    {
+        int i = first_ge(data, data_count, entry);
+        bool found = (i < data_count && data[i] == entry);
+        if (is_leaf())
+            return leaf_position(found ? i + 1 : i);
+        if (found) // inner node
+            return subset[i + 1]->upper_bound(entry);
+        else
+            return subset[i]->upper_bound(entry);
+    }
+
     // return an iterator to this key. NULL if not there.
     Iterator find(const T &entry)
     {
@@ -461,7 +769,7 @@ public:
         int count = 0;
         if (data_count == 0 && child_count == 0 && next == NULL)
             return 0;
-        for (BPlusTree<T>::Iterator it = begin();
+        for (Iterator it = begin();
              it != end(); it++)
             ++count;
         return count;
@@ -473,7 +781,7 @@ public:
      * *************************************************************
      */
     // performs a shallow copy
-    void shallow_copy(const BPlusTree<T> &other)
+    void shallow_copy(const BPlusTree &other)
     {
         // copy data
         copy_array(data, other.data,
@@ -537,7 +845,7 @@ private:
      *              P R I V A T E   V A R I A B L E S
      * *************************************************************
      */
-    static const int MINIMUM = 1;
+    static const int MINIMUM = MIN;
     static const int MAXIMUM = 2 * MINIMUM;
 
     // true if duplicate keys may be inserted
@@ -561,6 +869,12 @@ private:
     // essentially a linked list
     BPlusTree *next;
 
+    // where the nodes of the tree come from. the root makes the pool
+    // the first time it needs a node and owns it, every other node
+    // points to the root's pool
+    NodePool<BPlusTree> *pool;
+    bool owns_pool;
+
     /*
      * *************************************************************
      *              P R I V A T E   F U N C T I O N S
@@ -572,6 +886,44 @@ private:
         return child_count == 0;
     }
 
+    /*
+     * *************************************************************
+     *              N O D E     A L L O C A T I O N
+     * *************************************************************
+     */
+    // returns a new empty node from the tree's pool
+    BPlusTree *make_node(bool dups = true)
+    {
+        if (!pool)
+        {
+            pool = new NodePool<BPlusTree>;
+            owns_pool = true;
+        }
+        BPlusTree *node = new (pool->allocate()) BPlusTree(dups);
+        node->pool = pool;
+        return node;
+    }
+
+    // destroys node and everything under it, giving the nodes back
+    // to the pool
+    void free_node(BPlusTree *node)
+    {
+        node->~BPlusTree();
+        pool->release(node);
+    }
+
+    // runs the destructor of every node under this one without giving
+    // any of them back, for when the whole pool is about to be reset
+    void destroy_children()
+    {
+        for (int i = 0; i < child_count; i++)
+        {
+            subset[i]->destroy_children();
+            subset[i]->~BPlusTree();
+        }
+        child_count = 0;
+    }
+
     /*
      * *************************************************************
      *              U S E D     I N     I N S E R T
@@ -633,7 +985,7 @@ private:
     void fix_excess(int i)
     {
         T temp;
-        BPlusTree *rightChild = new BPlusTree<T>;
+        BPlusTree *rightChild = make_node();
 
         // Add a new subset at location i + 1 of this node
         insert_item(subset, i + 1, child_count, rightChild);
@@ -755,7 +1107,7 @@ private:
     }
 
     // fix shortage of data elements in child i
-    BPlusTree<T> *fix_shortage(int i)
+    BPlusTree *fix_shortage(int i)
     {
         // four cases
         // 1a. Transfer an extra entry from subset[i-1]
@@ -830,7 +1182,7 @@ private:
     void rotate_left(int i)
     {
         T store;
-        BPlusTree *subTemp = new BPlusTree<T>;
+        BPlusTree *subTemp = NULL;
 
         // transfer item data[i-1] tp the back of subset[i-1]
         delete_item(data, i - 1, data_count, store);
@@ -857,7 +1209,7 @@ private:
     void rotate_right(int i)
     {
         T store;
-        BPlusTree *subTemp = new BPlusTree<T>;
+        BPlusTree *subTemp = NULL;
 
         // transfer item data[i] to the front of subset[i+1]
         delete_item(data, i, data_count, store);
@@ -885,7 +1237,7 @@ private:
         if (subset[i]->is_leaf())
         {
             T store;
-            BPlusTree *subTemp = new BPlusTree<T>;
+            BPlusTree *subTemp = NULL;
 
             // delete but do not bring down
             delete_item(data, i, data_count, store);
@@ -905,7 +1257,7 @@ private:
             subset[i]->next = subTemp->next;
 
             // then delete subTemp
-            delete subTemp;
+            free_node(subTemp);
         }
         else
         {
@@ -917,7 +1269,7 @@ private:
     void merge_with_next_sub_original(int i)
     {
         T store;
-        BPlusTree *subTemp = new BPlusTree<T>;
+        BPlusTree *subTemp = NULL;
 
         // transfer data[i] to end of subset[i]
         delete_item(data, i, data_count, store);
@@ -931,7 +1283,7 @@ private:
 
         // delete subset[i+1], store in subTemp, then delete it
         delete_item(subset, i + 1, child_count, subTemp);
-        delete subTemp;
+        free_node(subTemp);
     }
 
     /*
@@ -940,7 +1292,7 @@ private:
      * *************************************************************
      */
     // return smallest node from tree
-    BPlusTree<T> *get_smallest_node()
+    BPlusTree *get_smallest_node()
     {
         if (is_leaf())
         {
@@ -954,6 +1306,15 @@ private:
         }
     }
 
+    // Iterator to entry i of this leaf. past the last entry is the
+    // first entry of the next leaf
+    Iterator leaf_position(int i)
+    {
+        if (i < data_count)
+            return Iterator(this, i);
+        return Iterator(next);
+    }
+
     /*
      * *************************************************************
      *              H E L P E R     F U N C T I O N S
@@ -979,6 +1340,21 @@ private:
         }
     }
 
+    // used by build: makes children[0..count) the children of this
+    // node. the key in front of every child but the first is the
+    // smallest key under it
+    void adopt(BPlusTree *children[], int count)
+    {
+        for (int j = 0; j < count; ++j)
+        {
+            subset[j] = children[j];
+            if (j > 0)
+                children[j]->get_smallest(data[j - 1]);
+        }
+        child_count = count;
+        data_count = count - 1;
+    }
+
     // entry := leftmost leaf
     void get_smallest(T &entry)
     {
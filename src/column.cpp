@@ -0,0 +1,192 @@
+#include "column.h"
+#include <cerrno>
+#include <cstdint>
+
+static const char *TYPE_NAMES[] = {"string", "int", "double", "date"};
+static const int TYPE_COUNT = 4;
+
+ColumnType column_type(const string &name)
+{
+    for (int i = 0; i < TYPE_COUNT; ++i)
+        if (name == TYPE_NAMES[i])
+            return static_cast<ColumnType>(i);
+    throw error("Unknown column type");
+}
+
+string column_type_name(ColumnType type)
+{
+    return TYPE_NAMES[type];
+}
+
+// 8 bytes, most significant first, so the bytes compare like x
+static string big_endian(uint64_t x)
+{
+    string key(8, '\0');
+    for (int i = 7; i >= 0; --i)
+    {
+        key[i] = static_cast<char>(x & 0xff);
+        x >>= 8;
+    }
+    return key;
+}
+
+// the 8 bytes of a key back into a number
+static uint64_t from_big_endian(const string &key)
+{
+    uint64_t x = 0;
+    for (size_t i = 0; i < 8 && i < key.size(); ++i)
+        x = x << 8 | static_cast<unsigned char>(key[i]);
+    return x;
+}
+
+// flipping the sign bit puts negative numbers before positive ones
+static string int_key(int64_t v)
+{
+    return big_endian(static_cast<uint64_t>(v) ^ (uint64_t(1) << 63));
+}
+
+// a positive double sorts like its bits with the sign bit set, a
+// negative one like all of its bits flipped
+static string double_key(double v)
+{
+    if (v == 0)
+        v = 0; // -0 and 0 are the same key
+    uint64_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    if (bits >> 63)
+        bits = ~bits;
+    else
+        bits ^= uint64_t(1) << 63;
+    return big_endian(bits);
+}
+
+// reads the digits of text[pos, pos + n) into v, false if there are
+// not n digits
+static bool read_digits(string_view text, size_t pos, size_t n, int &v)
+{
+    v = 0;
+    if (pos + n > text.size())
+        return false;
+    for (size_t i = pos; i < pos + n; ++i)
+    {
+        if (!isdigit(static_cast<unsigned char>(text[i])))
+            return false;
+        v = v * 10 + (text[i] - '0');
+    }
+    return true;
+}
+
+// days since 1970-01-01 of a date in the proleptic gregorian calendar
+static int64_t day_number(int y, int m, int d)
+{
+    y -= m <= 2;
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    int64_t yoe = y - era * 400;
+    int64_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+// the date of a day number, the other way around from day_number
+static string day_text(int64_t z)
+{
+    z += 719468;
+    int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    int64_t doe = z - era * 146097;
+    int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int64_t mp = (5 * doy + 2) / 153;
+    int d = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+    int m = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    int y = static_cast<int>(yoe + era * 400 + (m <= 2));
+    char text[16];
+    snprintf(text, sizeof(text), "%04d-%02d-%02d", y, m, d);
+    return text;
+}
+
+static int64_t parse_date(string_view text)
+{
+    static const int DAYS[] = {31, 29, 31, 30, 31, 30,
+                               31, 31, 30, 31, 30, 31};
+    int y, m, d;
+    if (text.size() != 10 || !read_digits(text, 0, 4, y) ||
+        !read_digits(text, 5, 2, m) || !read_digits(text, 8, 2, d) ||
+        text[4] != '-' || text[7] != '-')
+        throw error("Value is not a date (yyyy-mm-dd)");
+    bool leap = (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+    if (m < 1 || m > 12 || d < 1 || d > DAYS[m - 1] ||
+        (m == 2 && d == 29 && !leap))
+        throw error("Value is not a date (yyyy-mm-dd)");
+    return day_number(y, m, d);
+}
+
+string column_key(ColumnType type, string_view value)
+{
+    if (type == STRING_COLUMN)
+        return string(value);
+
+    // strtoll and strtod want a terminated string
+    string text(value);
+    const char *begin = text.c_str();
+    char *end = nullptr;
+    switch (type)
+    {
+    case INT_COLUMN:
+    {
+        errno = 0;
+        long long v = strtoll(begin, &end, 10);
+        if (text.empty() || *end != '\0' || errno == ERANGE)
+            throw error("Value is not an int");
+        return int_key(v);
+    }
+    case DOUBLE_COLUMN:
+    {
+        double v = strtod(begin, &end);
+        if (text.empty() || *end != '\0' || v != v)
+            throw error("Value is not a double");
+        return double_key(v);
+    }
+    case DATE_COLUMN:
+        return int_key(parse_date(value));
+    default:
+        return text;
+    }
+}
+
+string column_value(ColumnType type, const string &key)
+{
+    if (type == STRING_COLUMN)
+        return key;
+    uint64_t bits = from_big_endian(key);
+    switch (type)
+    {
+    case INT_COLUMN:
+        return to_string(static_cast<int64_t>(bits ^ (uint64_t(1) << 63)));
+    case DOUBLE_COLUMN:
+    {
+        if (bits >> 63)
+            bits ^= uint64_t(1) << 63;
+        else
+            bits = ~bits;
+        double v;
+        memcpy(&v, &bits, sizeof(v));
+        return double_text(v);
+    }
+    case DATE_COLUMN:
+        return day_text(static_cast<int64_t>(bits ^ (uint64_t(1) << 63)));
+    default:
+        return key;
+    }
+}
+
+string double_text(double v)
+{
+    char text[32];
+    for (int digits = 15; digits > 1; --digits)
+    {
+        int length = snprintf(text, sizeof(text), "%.*g", digits, v);
+        if (length <= DOUBLE_TEXT_WIDTH)
+            break;
+    }
+    return text;
+}
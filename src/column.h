@@ -0,0 +1,57 @@
+#ifndef COLUMN_H
+#define COLUMN_H
+
+#include "mylib.h"
+#include "error.h"
+#include <string_view>
+
+using namespace std;
+
+/*
+ * The type of a column, given after its name and a colon in make
+ * table:
+ *
+ *   make table employee fields last, first, salary:int, start:date
+ *
+ * A column without a type is a string. A type name on its own is a
+ * field like any other: fields title, date, place has three. Records
+ * keep every value as the text it was inserted as; the type decides
+ * how the column's index keys are made, and so how its values compare:
+ *
+ *   string   the text itself, compared as text
+ *   int      a 64 bit integer
+ *   double   a 64 bit floating point number
+ *   date     yyyy-mm-dd, kept as a day number
+ *
+ * Negative numbers and dates have to be quoted in a command, since
+ * the tokenizer splits them at the '-'.
+ *
+ * Numbers and dates become 8 byte keys whose bytes sort in the same
+ * order as their values, so the indices (MMap<string, int>) still
+ * compare keys as strings and get numeric order out of it.
+ */
+enum ColumnType {STRING_COLUMN, INT_COLUMN, DOUBLE_COLUMN, DATE_COLUMN};
+
+//the type called name, throws if there is no such type
+ColumnType column_type(const string& name);
+
+//the name of type
+string column_type_name(ColumnType type);
+
+//the index key of value in a column of type. throws if value is not
+//a value of type
+string column_key(ColumnType type, string_view value);
+
+//the value key was made from by column_key, as text. numbers and dates
+//come back in their plain form, 7 for 007
+string column_value(ColumnType type, const string& key);
+
+//the most chars double_text gives: a field of Table::print_rows is 15
+//wide, so a value still has a blank before it
+const int DOUBLE_TEXT_WIDTH = 14;
+
+//a double as text, to as many significant digits (at most 15) as fit
+//in DOUBLE_TEXT_WIDTH chars
+string double_text(double v);
+
+#endif // COLUMN_H
@@ -0,0 +1,837 @@
+#include "executor.h"
+#include "page.h"
+#include "group_table.h"
+#include <cstdio>
+
+bool Operator::profiling = false;
+bool Operator::planning = false;
+
+Timer::Timer(double &total) : total(total), on(Operator::profiling)
+{
+    if (on)
+        start = chrono::steady_clock::now();
+}
+
+Timer::~Timer()
+{
+    if (on)
+        total += chrono::duration<double, milli>(
+                     chrono::steady_clock::now() - start)
+                     .count();
+}
+
+// the lookups ran before the operator was made, their time is its own
+void Operator::found_by(PlanStep lookup)
+{
+    elapsed += lookup.ms;
+    lookups.push_back(std::move(lookup));
+}
+
+PlanStep Operator::plan() const
+{
+    PlanStep step;
+    step.what = describe();
+    step.rows = pulled;
+    step.planned = size();
+    step.estimate = estimated;
+    step.records = records_read();
+    step.bytes = io_bytes();
+    step.ms = elapsed;
+    step.inputs = lookups;
+    vector<const Operator *> in = inputs();
+    for (size_t i = 0; i < in.size(); ++i)
+        step.inputs.push_back(in[i]->plan());
+    return step;
+}
+
+// -> index lookup on student  (rows in=3 out=3, records=3, bytes=4096,
+//    0.052 ms)
+void print_plan(ostream &outs, const PlanStep &step, bool analyzed,
+                int depth)
+{
+    // the rows that came in are the ones the inputs handed out, if
+    // any of them is about rows
+    long in = -1;
+    for (size_t i = 0; i < step.inputs.size(); ++i)
+        if (step.inputs[i].rows >= 0)
+            in = max(in, 0L) + step.inputs[i].rows;
+
+    ostringstream counts;
+    if (step.planned >= 0 && !analyzed)
+        counts << ", rows=" << step.planned;
+    else if (step.rows >= 0 && analyzed)
+    {
+        if (in < 0)
+            counts << ", rows=" << step.rows;
+        else
+            counts << ", rows in=" << in << " out=" << step.rows;
+    }
+    if (step.estimate >= 0)
+        counts << ", est=" << step.estimate;
+    if (analyzed)
+    {
+        if (step.records > 0)
+            counts << ", records=" << step.records;
+        if (step.bytes > 0)
+            counts << ", bytes=" << step.bytes;
+        counts << ", " << fixed << setprecision(3) << step.ms << " ms";
+    }
+
+    outs << string(depth * 3, ' ') << "-> " << step.what;
+    if (!counts.str().empty())
+        outs << "  (" << counts.str().substr(2) << ")";
+    outs << endl;
+    for (size_t i = 0; i < step.inputs.size(); ++i)
+        print_plan(outs, step.inputs[i], analyzed, depth + 1);
+}
+
+// what is a field name or a value, escape the characters JSON needs
+static void print_json_string(ostream &outs, const string &s)
+{
+    outs << '"';
+    for (size_t i = 0; i < s.size(); ++i)
+    {
+        unsigned char c = static_cast<unsigned char>(s[i]);
+        if (c == '"' || c == '\\')
+            outs << '\\' << s[i];
+        else if (c < 0x20)
+        {
+            char hex[8];
+            snprintf(hex, sizeof(hex), "\\u%04x", c);
+            outs << hex;
+        }
+        else
+            outs << s[i];
+    }
+    outs << '"';
+}
+
+void print_plan_json(ostream &outs, const PlanStep &step)
+{
+    outs << "{\"step\": ";
+    print_json_string(outs, step.what);
+    long in = 0;
+    for (size_t i = 0; i < step.inputs.size(); ++i)
+        in += max(step.inputs[i].rows, 0L);
+    outs << ", \"rows_planned\": " << step.planned
+         << ", \"rows_in\": " << in
+         << ", \"rows_out\": " << step.rows
+         << ", \"estimate\": " << step.estimate
+         << ", \"records\": " << step.records
+         << ", \"bytes\": " << step.bytes
+         << ", \"ms\": " << fixed << setprecision(3) << step.ms
+         << ", \"inputs\": [";
+    outs.unsetf(ios_base::floatfield);
+    for (size_t i = 0; i < step.inputs.size(); ++i)
+    {
+        if (i > 0)
+            outs << ", ";
+        print_plan_json(outs, step.inputs[i]);
+    }
+    outs << "]}";
+}
+
+// b-files are called table.bin
+static string table_of(const string &name)
+{
+    size_t dot = name.rfind(".bin");
+    if (dot != string::npos && dot + 4 == name.size())
+        return name.substr(0, dot);
+    return name;
+}
+
+// a scan reads the file front to back, so tell the reader
+TableScan::TableScan(const string &name, long count)
+    : reader(name, true), count(count), recno(0)
+{
+    label = "table scan on " + table_of(name);
+}
+
+bool TableScan::next(Row &row)
+{
+    if (recno >= count)
+        return false;
+    row.recno = static_cast<int>(recno);
+    row.record = reader.view(recno);
+    recno++;
+    return true;
+}
+
+IndexLookup::IndexLookup(const string &name, vector<int> recnos)
+    : reader(name), recnos(recnos), pos(0)
+{
+    label = "index lookup on " + table_of(name);
+}
+
+bool IndexLookup::next(Row &row)
+{
+    if (pos >= recnos.size())
+        return false;
+    row.recno = recnos[pos++];
+    row.record = reader.view(row.recno);
+    return true;
+}
+
+Project::Project(unique_ptr<Operator> child, vector<int> columns)
+    : child(std::move(child)), fields(columns)
+{
+}
+
+Limit::Limit(unique_ptr<Operator> child, long offset, long count)
+    : child(std::move(child)), offset(offset), count(count), produced(-1)
+{
+    label = "limit " + (count < 0 ? string("all") : to_string(count));
+    if (offset > 0)
+        label += " offset " + to_string(offset);
+}
+
+bool Limit::next(Row &row)
+{
+    // skip the offset the first time through
+    if (produced < 0)
+    {
+        for (long i = 0; i < offset; ++i)
+            if (!child->pull(row))
+                return false;
+        produced = 0;
+    }
+    if (count >= 0 && produced >= count)
+        return false;
+    if (!child->pull(row))
+        return false;
+    produced++;
+    return true;
+}
+
+long Limit::size() const
+{
+    if (child->size() < 0)
+        return -1;
+    long left = max(child->size() - offset, 0L);
+    return count < 0 ? left : min(left, count);
+}
+
+Values::Values(vector<string> names, const vector<vector<string>> &rows)
+    : fieldNames(names), pos(0)
+{
+    label = "values";
+    for (size_t i = 0; i < rows.size(); ++i)
+        this->rows.push_back(Record(rows[i]));
+}
+
+bool Values::next(Row &row)
+{
+    if (pos >= rows.size())
+        return false;
+    row.recno = static_cast<int>(pos);
+    row.record = rows[pos++].view();
+    return true;
+}
+
+AggregateFunction aggregate_function(const string &name)
+{
+    static const char *NAMES[] = {"count", "sum", "avg", "min", "max"};
+    for (int i = 0; i < 5; ++i)
+        if (name == NAMES[i])
+            return static_cast<AggregateFunction>(COUNT + i);
+    throw error("Unknown aggregate function");
+}
+
+Aggregate::Aggregate(unique_ptr<Operator> child,
+                     const vector<AggregateColumn> &columns, int group,
+                     const vector<ColumnType> &types,
+                     const vector<string> &names, bool descending)
+    : Values(names), grouped(!planning), group(group)
+{
+    Timer timer(elapsed);
+    label = "hash aggregate";
+    for (size_t k = 0; k < names.size(); ++k)
+        label += (k == 0 ? " " : ", ") + names[k];
+    for (size_t k = 0; k < columns.size(); ++k)
+    {
+        AggregateFunction f = columns[k].function;
+        if ((f == SUM || f == AVG) && types[columns[k].col] != INT_COLUMN &&
+            types[columns[k].col] != DOUBLE_COLUMN)
+            throw error("Invalid Input: sum and avg need an int or double field");
+    }
+
+    if (!grouped)
+    {
+        this->child = std::move(child);
+        return;
+    }
+
+    // group number -> its totals, columns.size() of them in a row
+    size_t width = columns.size();
+    GroupTable groups;
+    vector<string> texts;
+    vector<Total> totals;
+    if (group < 0)
+    {
+        // no group by: one group, even if there are no rows
+        texts.push_back(string());
+        totals.resize(width);
+    }
+
+    Row row;
+    while (child->pull(row))
+    {
+        size_t g = 0;
+        if (group >= 0)
+        {
+            string_view text = row.record.entry(group);
+            g = groups.insert(types[group] == STRING_COLUMN
+                                  ? string(text)
+                                  : column_key(types[group], text));
+            if (g == texts.size())
+            {
+                texts.push_back(string(text));
+                totals.resize(totals.size() + width);
+            }
+        }
+        for (size_t k = 0; k < width; ++k)
+        {
+            int col = columns[k].col;
+            add(totals[g * width + k], columns[k],
+                col < 0 ? STRING_COLUMN : types[col],
+                col < 0 ? string_view() : row.record.entry(col));
+        }
+    }
+
+    // the groups in key order
+    vector<int> order(texts.size());
+    for (size_t g = 0; g < order.size(); ++g)
+        order[g] = static_cast<int>(g);
+    if (group >= 0)
+        sort(order.begin(), order.end(), [&](int a, int b)
+             { return descending ? groups.key(b) < groups.key(a)
+                                 : groups.key(a) < groups.key(b); });
+
+    vector<string> values(width);
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        size_t g = order[i];
+        for (size_t k = 0; k < width; ++k)
+        {
+            int col = columns[k].col;
+            values[k] = columns[k].function == GROUP_FIELD
+                            ? texts[g]
+                            : result(totals[g * width + k], columns[k],
+                                     col < 0 ? STRING_COLUMN : types[col]);
+        }
+        rows.push_back(Record(values));
+    }
+    this->child = std::move(child);
+}
+
+// without a group by there is one row, grouped or not
+long Aggregate::size() const
+{
+    if (grouped)
+        return Values::size();
+    return group < 0 ? 1 : -1;
+}
+
+void Aggregate::add(Total &total, const AggregateColumn &column,
+                    ColumnType type, string_view value)
+{
+    total.count++;
+    switch (column.function)
+    {
+    case SUM:
+    case AVG:
+    {
+        // strtoll and strtod want a terminated string
+        string text(value);
+        if (type == INT_COLUMN)
+            total.isum += strtoll(text.c_str(), nullptr, 10);
+        else
+            total.dsum += strtod(text.c_str(), nullptr);
+        break;
+    }
+    case MIN:
+    case MAX:
+    {
+        string key = column_key(type, value);
+        if (total.count == 1 ||
+            (column.function == MIN ? key < total.bestKey
+                                    : total.bestKey < key))
+        {
+            total.bestKey = key;
+            total.bestText = string(value);
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+// sum, avg, min and max of no rows are empty
+string Aggregate::result(const Total &total, const AggregateColumn &column,
+                         ColumnType type)
+{
+    if (column.function == COUNT)
+        return to_string(total.count);
+    if (total.count == 0)
+        return string();
+    switch (column.function)
+    {
+    case SUM:
+        return type == INT_COLUMN ? to_string(total.isum)
+                                  : double_text(total.dsum);
+    case AVG:
+        return double_text((type == INT_COLUMN
+                                ? static_cast<double>(total.isum)
+                                : total.dsum) /
+                           total.count);
+    default:
+        return total.bestText;
+    }
+}
+
+Join::Join(const string &outerName, const string &innerName,
+           vector<string> names, string how)
+    : outer(outerName), inner(innerName), matched(!planning), pos(0),
+      fieldNames(names), how(how)
+{
+    label = how;
+}
+
+vector<const Operator *> Join::inputs() const
+{
+    vector<const Operator *> in;
+    if (outerRows)
+        in.push_back(outerRows.get());
+    if (innerRows)
+        in.push_back(innerRows.get());
+    return in;
+}
+
+// an index join reads the inner records as it looks them up, a hash
+// join reads them through its inner rows as well
+long Join::records_read() const
+{
+    return outer.records_read() + inner.records_read();
+}
+
+long Join::io_bytes() const
+{
+    return outer.bytes_read() + inner.bytes_read();
+}
+
+bool Join::next(Row &row)
+{
+    if (pos >= matches.size())
+        return false;
+    // the joined record is the fields of both, encoded again
+    RecordView a = outer.view(matches[pos].first);
+    vector<string> fields;
+    fields.reserve(fieldNames.size());
+    for (int i = 0; i < a.field_count(); ++i)
+        fields.push_back(string(a.entry(i)));
+    RecordView b = inner.view(matches[pos].second);
+    for (int i = 0; i < b.field_count(); ++i)
+        fields.push_back(string(b.entry(i)));
+    joined = Record(fields);
+    row.recno = static_cast<int>(pos++);
+    row.record = joined.view();
+    return true;
+}
+
+IndexJoin::IndexJoin(const string &outerName,
+                     unique_ptr<Operator> outerRows, int outerCol,
+                     ColumnType type, const string &innerName,
+                     MMap<string, int> &index, const RecnoSet *keep,
+                     vector<string> names, string how)
+    : Join(outerName, innerName, names, how)
+{
+    Timer timer(elapsed);
+    Row row;
+    while (matched && outerRows->pull(row))
+    {
+        string key = column_key(type, row.record.entry(outerCol));
+        MMap<string, int>::Iterator it = index.lower_bound(key);
+        if (it == index.end() || it->key != key)
+            continue;
+        for (int recno : it->value_list)
+            if (keep == NULL || keep->contains(recno))
+                matches.push_back(make_pair(row.recno, recno));
+    }
+    this->outerRows = std::move(outerRows);
+}
+
+// build: the inner record numbers of each key, chained in record
+// order. probe: every outer row walks the chain of its key
+HashJoin::HashJoin(const string &outerName, unique_ptr<Operator> outerRows,
+                   int outerCol, const string &innerName,
+                   unique_ptr<Operator> innerRows, int innerCol,
+                   ColumnType type, vector<string> names, string how)
+    : Join(outerName, innerName, names, how)
+{
+    Timer timer(elapsed);
+    GroupTable keys;
+    vector<int> first;
+    vector<int> last;
+    vector<int> recnos;
+    vector<int> chain;
+    Row row;
+    while (matched && innerRows->pull(row))
+    {
+        string_view text = row.record.entry(innerCol);
+        size_t g = keys.insert(type == STRING_COLUMN
+                                   ? string(text)
+                                   : column_key(type, text));
+        int entry = static_cast<int>(recnos.size());
+        recnos.push_back(row.recno);
+        chain.push_back(-1);
+        if (g == first.size())
+        {
+            first.push_back(entry);
+            last.push_back(entry);
+        }
+        else
+        {
+            chain[last[g]] = entry;
+            last[g] = entry;
+        }
+    }
+
+    while (matched && outerRows->pull(row))
+    {
+        int g = keys.find(column_key(type, row.record.entry(outerCol)));
+        if (g < 0)
+            continue;
+        for (int e = first[g]; e != -1; e = chain[e])
+            matches.push_back(make_pair(row.recno, recnos[e]));
+    }
+    this->outerRows = std::move(outerRows);
+    this->innerRows = std::move(innerRows);
+}
+
+IndexOrder::IndexOrder(const string &name, MMap<string, int> &index,
+                       bool descending, long count)
+    : reader(name), index(index), descending(descending), count(count),
+      filter(false), started(false), forward(index.end())
+{
+}
+
+IndexOrder::IndexOrder(const string &name, MMap<string, int> &index,
+                       bool descending, long count, RecnoSet keep)
+    : reader(name), index(index), descending(descending), count(count),
+      filter(true), keep(std::move(keep)), started(false),
+      forward(index.end())
+{
+}
+
+bool IndexOrder::next_key()
+{
+    if (!started)
+    {
+        started = true;
+        // begin() of an empty tree is not end()
+        if (index.empty())
+            return false;
+        forward = index.begin();
+        backward = index.rbegin();
+    }
+    else if (descending)
+        ++backward;
+    else
+        ++forward;
+
+    if (descending ? backward == index.rend() : forward == index.end())
+        return false;
+    posting = descending ? backward->value_list.begin()
+                         : forward->value_list.begin();
+    return true;
+}
+
+bool IndexOrder::next(Row &row)
+{
+    while (true)
+    {
+        if (started && posting != PostingList::Iterator())
+        {
+            int recno = *posting;
+            ++posting;
+            if (filter && !keep.contains(recno))
+                continue;
+            row.recno = recno;
+            row.record = reader.view(recno);
+            return true;
+        }
+        if (!next_key())
+            return false;
+    }
+}
+
+// a run is a list of (key length, key, recno)
+static void write_entry(fstream &out, const string &key, int recno,
+                        long &bytes)
+{
+    char num[4];
+    put32(num, static_cast<int>(key.size()));
+    out.write(num, 4);
+    out.write(key.data(), key.size());
+    put32(num, recno);
+    out.write(num, 4);
+    bytes += 8 + static_cast<long>(key.size());
+}
+
+// reads the next entry of a run into key and recno. false at the end of
+// the run, throws if the run cannot be read
+static bool read_entry(fstream &in, string &key, int &recno, long &bytes)
+{
+    char num[4];
+    if (!in.read(num, 4))
+    {
+        if (in.gcount() == 0 && in.eof())
+            return false;
+        throw error("Sort run is corrupt");
+    }
+    key.resize(get32(num));
+    in.read(&key[0], key.size());
+    in.read(num, 4);
+    if (in.fail())
+        throw error("Sort run is corrupt");
+    recno = get32(num);
+    bytes += 8 + static_cast<long>(key.size());
+    return true;
+}
+
+static unique_ptr<fstream> open_run(const string &file)
+{
+    unique_ptr<fstream> in(
+        new fstream(file, std::fstream::in | std::fstream::binary));
+    if (in->fail())
+        throw error("Could not read sort run");
+    return in;
+}
+
+// reads every record once to make its key. whenever the keys held go
+// over budget they are sorted and written out as a run
+Sort::Sort(const string &name, const vector<int> &recnos, int col,
+           ColumnType type, bool descending, size_t budget, long limit)
+    : reader(name), count(static_cast<long>(recnos.size())),
+      descending(descending), topK(false), pos(0), runName(name + ".sort"),
+      spilled(0), passes(0), runBytes(0)
+{
+    Timer timer(elapsed);
+    label = "sort on " + table_of(name);
+    if (limit >= 0 && limit < count)
+    {
+        topK = true;
+        if (!planning)
+            top(recnos, col, type, static_cast<size_t>(limit));
+        count = limit;
+        return;
+    }
+    if (planning)
+        return;
+
+    size_t bytes = 0;
+    for (size_t i = 0; i < recnos.size(); ++i)
+    {
+        Entry e;
+        e.key = column_key(type, reader.view(recnos[i]).entry(col));
+        e.recno = recnos[i];
+        bytes += sizeof(Entry) + e.key.size();
+        entries.push_back(std::move(e));
+        if (bytes > budget)
+        {
+            spill();
+            bytes = 0;
+        }
+    }
+
+    // everything fit: the entries are the result
+    if (runFiles.empty())
+    {
+        sort(entries.begin(), entries.end(),
+             [this](const Entry &a, const Entry &b)
+             { return before(a, b); });
+        return;
+    }
+
+    // merge the runs, at most SORT_FAN_IN at a time, until there are
+    // few enough to open at once. then heap them on their first entry
+    if (!entries.empty())
+        spill();
+    while (left.size() > SORT_FAN_IN)
+    {
+        size_t runs = left.size();
+        for (size_t first = 0; first < runs; first += SORT_FAN_IN)
+            merge_runs(first, min(SORT_FAN_IN, runs - first));
+        left.erase(left.begin(), left.begin() + runs);
+        passes++;
+    }
+    heads.resize(left.size());
+    for (size_t k = 0; k < left.size(); ++k)
+    {
+        runs_in.push_back(open_run(left[k]));
+        if (read_head(static_cast<int>(k)))
+            heap.push_back(static_cast<int>(k));
+    }
+    make_heap(heap.begin(), heap.end(), [this](int a, int b)
+              { return before(heads[b], heads[a]); });
+}
+
+Sort::~Sort()
+{
+    runs_in.clear();
+    for (size_t k = 0; k < runFiles.size(); ++k)
+        remove(runFiles[k].c_str());
+}
+
+// sort on student.age desc, top 10 / 3 runs merged
+string Sort::describe() const
+{
+    if (topK)
+        return label + ", top " + to_string(count);
+    if (passes > 0)
+        return label + ", " + to_string(spilled) + " runs merged in " +
+               to_string(passes + 1) + " passes";
+    if (spilled > 0)
+        return label + ", " + to_string(spilled) + " runs merged";
+    return label;
+}
+
+// key order, largest first if descending. equal keys keep record order
+bool Sort::before(const Entry &a, const Entry &b) const
+{
+    if (a.key != b.key)
+        return descending ? b.key < a.key : a.key < b.key;
+    return a.recno < b.recno;
+}
+
+// top-k: entries is a heap with the last of the kept entries on top,
+// a new entry only goes in if it comes before that one
+void Sort::top(const vector<int> &recnos, int col, ColumnType type,
+               size_t limit)
+{
+    auto cmp = [this](const Entry &a, const Entry &b)
+    { return before(a, b); };
+    if (limit == 0)
+        return;
+    entries.reserve(limit);
+    Entry e;
+    for (size_t i = 0; i < recnos.size(); ++i)
+    {
+        e.key = column_key(type, reader.view(recnos[i]).entry(col));
+        e.recno = recnos[i];
+        if (entries.size() < limit)
+        {
+            entries.push_back(e);
+            push_heap(entries.begin(), entries.end(), cmp);
+        }
+        else if (before(e, entries.front()))
+        {
+            pop_heap(entries.begin(), entries.end(), cmp);
+            swap(entries.back(), e);
+            push_heap(entries.begin(), entries.end(), cmp);
+        }
+    }
+    sort_heap(entries.begin(), entries.end(), cmp);
+}
+
+string Sort::new_run()
+{
+    string file = runName + to_string(runFiles.size());
+    runFiles.push_back(file);
+    left.push_back(file);
+    return file;
+}
+
+void Sort::spill()
+{
+    sort(entries.begin(), entries.end(),
+         [this](const Entry &a, const Entry &b)
+         { return before(a, b); });
+    string file = new_run();
+    spilled++;
+    fstream out(file, std::fstream::out | std::fstream::binary |
+                          std::fstream::trunc);
+    if (out.fail())
+        throw error("Could not write sort run");
+    for (size_t i = 0; i < entries.size(); ++i)
+        write_entry(out, entries[i].key, entries[i].recno, runBytes);
+    out.close();
+    if (out.fail())
+        throw error("Could not write sort run");
+    entries.clear();
+}
+
+// one pass of the merge for n runs: the same heap as next, written out
+// to a run instead of handed out as rows
+void Sort::merge_runs(size_t first, size_t n)
+{
+    vector<unique_ptr<fstream>> in;
+    vector<Entry> head(n);
+    vector<int> order;
+    auto after = [this, &head](int a, int b)
+    { return before(head[b], head[a]); };
+    for (size_t k = 0; k < n; ++k)
+    {
+        in.push_back(open_run(left[first + k]));
+        if (read_entry(*in[k], head[k].key, head[k].recno, runBytes))
+            order.push_back(static_cast<int>(k));
+    }
+    make_heap(order.begin(), order.end(), after);
+
+    string file = new_run();
+    fstream out(file, std::fstream::out | std::fstream::binary |
+                          std::fstream::trunc);
+    if (out.fail())
+        throw error("Could not write sort run");
+    while (!order.empty())
+    {
+        pop_heap(order.begin(), order.end(), after);
+        int k = order.back();
+        write_entry(out, head[k].key, head[k].recno, runBytes);
+        if (read_entry(*in[k], head[k].key, head[k].recno, runBytes))
+            push_heap(order.begin(), order.end(), after);
+        else
+            order.pop_back();
+    }
+    out.close();
+    if (out.fail())
+        throw error("Could not write sort run");
+
+    // the merged runs are done with
+    in.clear();
+    for (size_t k = 0; k < n; ++k)
+        remove(left[first + k].c_str());
+}
+
+bool Sort::read_head(int k)
+{
+    return read_entry(*runs_in[k], heads[k].key, heads[k].recno, runBytes);
+}
+
+bool Sort::next(Row &row)
+{
+    if (runFiles.empty())
+    {
+        if (pos >= entries.size())
+            return false;
+        row.recno = entries[pos++].recno;
+    }
+    else
+    {
+        if (heap.empty())
+            return false;
+        auto after = [this](int a, int b)
+        { return before(heads[b], heads[a]); };
+        pop_heap(heap.begin(), heap.end(), after);
+        int k = heap.back();
+        row.recno = heads[k].recno;
+        // refill from the run that was taken from
+        if (read_head(k))
+            push_heap(heap.begin(), heap.end(), after);
+        else
+            heap.pop_back();
+    }
+    row.record = reader.view(row.recno);
+    return true;
+}
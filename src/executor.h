@@ -0,0 +1,540 @@
+#ifndef EXECUTOR_H
+#define EXECUTOR_H
+
+#include "mylib.h"
+#include "table_reader.h"
+#include "mmap.h"
+#include "recno_set.h"
+#include "column.h"
+#include "record.h"
+#include <chrono>
+#include <memory>
+
+using namespace std;
+
+/*
+ * A select is run as a short pipeline of operators. Each operator
+ * hands out one row at a time when it is asked for it (next), so rows
+ * go from the b-file to the output without being copied into a
+ * temporary table.
+ *
+ *   TableScan     every record of a table, in record order
+ *   IndexLookup   the records whose numbers were found in the indices
+ *   Project       the rows of another operator, cut down to a list of
+ *                 fields
+ *   IndexOrder    records in the key order of an index, either way
+ *   Sort          the records whose numbers were found, sorted on a
+ *                 field. runs that do not fit in memory are sorted on
+ *                 their own, spilled to disk and merged. with a limit
+ *                 only the first rows are kept, in a bounded heap
+ *   Limit         a window of the rows of another operator. it stops
+ *                 pulling from it once the window is full, so a scan
+ *                 under it never reads past the rows it needs
+ *   Values        rows worked out up front, with fields of their own
+ *                 instead of the table's
+ *   Aggregate     the groups of the rows of another operator and the
+ *                 count/sum/avg/min/max of each, hashed on the group
+ *                 by field (see GroupTable)
+ *   IndexJoin     the rows of an outer operator joined to the records
+ *                 of another table, looked up in its index
+ *   HashJoin      the same, with the inner rows hashed on their join
+ *                 field first, for when the index is not at hand
+ *
+ * The output is the sink at the end of the pipeline (see
+ * Table::print_rows).
+ *
+ * Every operator counts the rows it hands out and, while profiling is
+ * on (explain analyze), the time spent in it. plan() turns a pipeline
+ * into a tree of PlanSteps for explain, along with the index lookups
+ * and and/or's that found the records it reads. While planning is on
+ * (a plain explain) the operators that read rows when they are made
+ * (sort, aggregate, the joins) are made without reading them, and the
+ * rows they would hand out are left to the statistics.
+ */
+
+//one step of a select, for explain: an operator of the pipeline, or
+//one of the index lookups and and/or's that found the records it reads
+struct PlanStep
+{
+    PlanStep(): rows(0), planned(0), estimate(-1), records(0), bytes(0),
+                ms(0) {}
+
+    string what;
+    //rows it handed out, -1 for a step that is not about rows (loading
+    //an index)
+    long rows;
+    //rows it was made to hand out (an operator's size), -1 likewise
+    long planned;
+    //rows the statistics of the table expect, -1 if not known
+    long estimate;
+    //records it read from a b-file
+    long records;
+    //bytes it read from (or wrote to) files
+    long bytes;
+    //time spent in it and the steps under it, 0 unless profiling
+    double ms;
+    vector<PlanStep> inputs;
+};
+
+//prints step and the steps under it, one line each, indented by
+//depth. with analyzed the counts and times of a run are printed, else
+//only the rows planned
+void print_plan(ostream& outs, const PlanStep& step, bool analyzed,
+                int depth = 0);
+
+//writes step and the steps under it as a JSON object
+void print_plan_json(ostream& outs, const PlanStep& step);
+
+//adds the milliseconds from when it is made to when it goes away to
+//total, while Operator::profiling is on
+class Timer
+{
+public:
+    explicit Timer(double& total);
+    ~Timer();
+
+    Timer(const Timer&) = delete;
+    Timer& operator =(const Timer&) = delete;
+
+private:
+    double& total;
+    bool on;
+    chrono::steady_clock::time_point start;
+};
+
+//one row flowing through a pipeline. record points into the reader
+//of the operator that produced it and is valid until its next call
+struct Row
+{
+    int recno;
+    RecordView record;
+};
+
+class Operator
+{
+public:
+    Operator(): pulled(0), elapsed(0), estimated(-1) {}
+    virtual ~Operator() {}
+
+    //moves to the next row, false once there are none left
+    virtual bool next(Row& row) = 0;
+
+    //next, counted and timed. the rows of an operator are always
+    //pulled with this, by the operator above it or by the output
+    bool pull(Row& row)
+    {
+        Timer timer(elapsed);
+        if (!next(row))
+            return false;
+        pulled++;
+        return true;
+    }
+
+    //number of rows the operator produces, -1 if that is not known
+    //until it runs
+    virtual long size() const = 0;
+
+    //positions of the fields of a row that are part of the result,
+    //empty if all of them are
+    virtual vector<int> columns() const {return vector<int>();}
+
+    //names of the fields of a row, empty if they are the fields of
+    //the table
+    virtual vector<string> names() const {return vector<string>();}
+
+    //how the rows are found, if that is worth telling (which join)
+    virtual string strategy() const {return string();}
+
+    //what the operator is, for explain
+    virtual string describe() const {return label;}
+
+    //the operators it pulls rows from
+    virtual vector<const Operator*> inputs() const
+    {
+        return vector<const Operator*>();
+    }
+
+    //records the operator read from b-files and bytes of file it read
+    //or wrote itself, not counting its inputs
+    virtual long records_read() const {return 0;}
+    virtual long io_bytes() const {return 0;}
+
+    //names the operator for explain
+    void set_label(const string& what) {label = what;}
+
+    //the rows the statistics of the tables expect it to hand out
+    void set_estimate(long rows) {estimated = rows;}
+
+    //adds lookup, how the records of the operator were found before
+    //it was made, to its plan and its time
+    void found_by(PlanStep lookup);
+
+    //the operator and everything under it, with what each has done
+    PlanStep plan() const;
+
+    //true while a select is profiled: pulls and the work operators do
+    //when they are made are timed
+    static bool profiling;
+
+    //true while a select is only planned: operators are made without
+    //reading any rows, and are never pulled
+    static bool planning;
+
+protected:
+    string label;
+    //rows handed out by pull
+    long pulled;
+    //time spent in the operator and its inputs
+    double elapsed;
+    //rows expected by the statistics, -1 if not known
+    long estimated;
+    //how its records were found
+    vector<PlanStep> lookups;
+};
+
+class TableScan : public Operator
+{
+public:
+    //scans the first count records of the b-file called name
+    TableScan(const string& name, long count);
+
+    bool next(Row& row);
+    long size() const {return count;}
+    long records_read() const {return reader.records_read();}
+    long io_bytes() const {return reader.bytes_read();}
+
+private:
+    TableReader reader;
+    long count;
+    long recno;
+};
+
+class IndexLookup : public Operator
+{
+public:
+    //fetches the records numbered recnos, in that order, from the
+    //b-file called name
+    IndexLookup(const string& name, vector<int> recnos);
+
+    bool next(Row& row);
+    long size() const {return static_cast<long>(recnos.size());}
+    long records_read() const {return reader.records_read();}
+    long io_bytes() const {return reader.bytes_read();}
+
+private:
+    TableReader reader;
+    vector<int> recnos;
+    size_t pos;
+};
+
+class Project : public Operator
+{
+public:
+    //the rows of child, showing only the fields at positions columns.
+    //a row's record is still the whole record, only the fields in
+    //columns are ever decoded from it
+    Project(unique_ptr<Operator> child, vector<int> columns);
+
+    bool next(Row& row) {return child->pull(row);}
+    long size() const {return child->size();}
+    vector<int> columns() const {return fields;}
+    vector<string> names() const {return child->names();}
+    string strategy() const {return child->strategy();}
+    vector<const Operator*> inputs() const
+    {
+        return vector<const Operator*>(1, child.get());
+    }
+
+private:
+    unique_ptr<Operator> child;
+    vector<int> fields;
+};
+
+class Limit : public Operator
+{
+public:
+    //the rows of child after skipping the first offset of them, at
+    //most count rows (every row that is left if count is negative)
+    Limit(unique_ptr<Operator> child, long offset, long count);
+
+    bool next(Row& row);
+    long size() const;
+    vector<int> columns() const {return child->columns();}
+    vector<string> names() const {return child->names();}
+    string strategy() const {return child->strategy();}
+    vector<const Operator*> inputs() const
+    {
+        return vector<const Operator*>(1, child.get());
+    }
+
+private:
+    unique_ptr<Operator> child;
+    long offset;
+    long count;
+    //rows handed out so far, -1 until the offset has been skipped
+    long produced;
+};
+
+class Values : public Operator
+{
+public:
+    //rows, with fields called names
+    Values(vector<string> names, const vector<vector<string>>& rows);
+
+    bool next(Row& row);
+    long size() const {return static_cast<long>(rows.size());}
+    vector<string> names() const {return fieldNames;}
+
+protected:
+    Values(vector<string> names): fieldNames(names), pos(0) {}
+
+    vector<string> fieldNames;
+    vector<Record> rows;
+    size_t pos;
+};
+
+//what an aggregate column is worked out as. GROUP_FIELD is the group
+//by field itself
+enum AggregateFunction {GROUP_FIELD, COUNT, SUM, AVG, MIN, MAX};
+
+//the function called name (count, sum, ...), throws if there is none
+AggregateFunction aggregate_function(const string& name);
+
+struct AggregateColumn
+{
+    AggregateFunction function;
+    //the field it is worked out on, -1 for count(*)
+    int col;
+};
+
+class Aggregate : public Values
+{
+public:
+    //one row per distinct value of field group of the rows of child
+    //(a single row if group is -1), with the columns worked out on
+    //the rows of the group. types are the types of the table's fields,
+    //names the names of the columns. groups come out in the order of
+    //the group field, largest first if descending
+    Aggregate(unique_ptr<Operator> child,
+              const vector<AggregateColumn>& columns, int group,
+              const vector<ColumnType>& types,
+              const vector<string>& names, bool descending);
+
+    long size() const;
+    vector<const Operator*> inputs() const
+    {
+        return vector<const Operator*>(1, child.get());
+    }
+
+private:
+    //the rows that were grouped, kept for explain
+    unique_ptr<Operator> child;
+    //false if the groups were only planned. group is the group by
+    //field, -1 if there is none
+    bool grouped;
+    int group;
+
+    //the running total of one column of one group
+    struct Total
+    {
+        Total(): count(0), isum(0), dsum(0) {}
+        long count;
+        long long isum;
+        double dsum;
+        //the smallest (or largest) value so far, as key and as text
+        string bestKey;
+        string bestText;
+    };
+
+    //adds value, a field of type type, to total
+    static void add(Total& total, const AggregateColumn& column,
+                    ColumnType type, string_view value);
+    //what total comes out as
+    static string result(const Total& total, const AggregateColumn& column,
+                         ColumnType type);
+};
+
+class Join : public Operator
+{
+public:
+    //a joined row is the fields of the outer record followed by those
+    //of the inner one
+    bool next(Row& row);
+    long size() const
+    {
+        return matched ? static_cast<long>(matches.size()) : -1;
+    }
+    vector<string> names() const {return fieldNames;}
+    string strategy() const {return how;}
+    vector<const Operator*> inputs() const;
+    long records_read() const;
+    long io_bytes() const;
+
+protected:
+    //joins records of the b-file outerName to records of the b-file
+    //innerName. the joined rows have fields called names
+    Join(const string& outerName, const string& innerName,
+         vector<string> names, string how);
+
+    TableReader outer;
+    TableReader inner;
+    //the rows that were joined, kept for explain. there are no inner
+    //rows for an index join
+    unique_ptr<Operator> outerRows;
+    unique_ptr<Operator> innerRows;
+    //(outer recno, inner recno) of every joined row, outer order first
+    vector<pair<int, int>> matches;
+    //false if the join was only planned
+    bool matched;
+    size_t pos;
+    Record joined;
+    vector<string> fieldNames;
+    string how;
+};
+
+class IndexJoin : public Join
+{
+public:
+    //joins the rows of outerRows (records of the b-file outerName) to
+    //the records of the b-file innerName whose key in index, the index
+    //of the inner join field, is the key of outer field outerCol (of
+    //type type). if keep is not NULL only inner records in it join
+    IndexJoin(const string& outerName, unique_ptr<Operator> outerRows,
+              int outerCol, ColumnType type, const string& innerName,
+              MMap<string, int>& index, const RecnoSet* keep,
+              vector<string> names, string how);
+};
+
+class HashJoin : public Join
+{
+public:
+    //joins the rows of outerRows to the rows of innerRows whose inner
+    //field innerCol equals outer field outerCol (both of type type).
+    //the inner rows are hashed on it first, then the outer rows probe
+    HashJoin(const string& outerName, unique_ptr<Operator> outerRows,
+             int outerCol, const string& innerName,
+             unique_ptr<Operator> innerRows, int innerCol,
+             ColumnType type, vector<string> names, string how);
+};
+
+class IndexOrder : public Operator
+{
+public:
+    //the records of the b-file called name in the key order of index,
+    //largest key first if descending. records with the same key come
+    //in record order. count is the number of records produced
+    IndexOrder(const string& name, MMap<string, int>& index,
+               bool descending, long count);
+    //as above, but only the records in keep
+    IndexOrder(const string& name, MMap<string, int>& index,
+               bool descending, long count, RecnoSet keep);
+
+    bool next(Row& row);
+    long size() const {return count;}
+    long records_read() const {return reader.records_read();}
+    long io_bytes() const {return reader.bytes_read();}
+
+private:
+    //moves on to the posting list of the next key, false at the end
+    bool next_key();
+
+    TableReader reader;
+    MMap<string, int>& index;
+    bool descending;
+    long count;
+    bool filter;
+    RecnoSet keep;
+
+    //false until the first key has been found
+    bool started;
+    MMap<string, int>::Iterator forward;
+    MMap<string, int>::ReverseIterator backward;
+    //the rest of the posting list of the current key
+    PostingList::Iterator posting;
+};
+
+//bytes of sort keys a Sort holds in memory before it spills a run
+const size_t SORT_BUDGET = 32 * 1024 * 1024;
+//most runs a Sort reads at once. more runs than this are merged in
+//passes, SORT_FAN_IN at a time, into longer runs first
+const size_t SORT_FAN_IN = 64;
+
+class Sort : public Operator
+{
+public:
+    //the records numbered recnos of the b-file called name, sorted on
+    //field col (of type type), largest first if descending. at most
+    //budget bytes of keys are kept in memory at once. if limit is not
+    //negative only the first limit rows are produced, and only their
+    //keys are ever kept
+    Sort(const string& name, const vector<int>& recnos, int col,
+         ColumnType type, bool descending, size_t budget = SORT_BUDGET,
+         long limit = -1);
+    ~Sort();
+
+    bool next(Row& row);
+    long size() const {return count;}
+    string describe() const;
+    long records_read() const {return reader.records_read();}
+    long io_bytes() const {return reader.bytes_read() + runBytes;}
+
+    //number of runs spilled to disk, 0 if the sort fit in memory
+    int runs() const {return spilled;}
+
+private:
+    //a record number and the sort key of its field
+    struct Entry
+    {
+        string key;
+        int recno;
+
+        //std::sort needs this, the swap of arrayfunctions.h would
+        //otherwise be as good a match as std::swap
+        friend void swap(Entry& a, Entry& b)
+        {
+            a.key.swap(b.key);
+            std::swap(a.recno, b.recno);
+        }
+    };
+
+    //true if a comes before b
+    bool before(const Entry& a, const Entry& b) const;
+    //keeps the first limit entries of recnos in a heap, then sorts them
+    void top(const vector<int>& recnos, int col, ColumnType type,
+             size_t limit);
+    //sorts the entries in memory and writes them to a new run file
+    void spill();
+    //a new run file, to be removed with the sort
+    string new_run();
+    //merges the n runs left from first on into one new run
+    void merge_runs(size_t first, size_t n);
+    //reads the next entry of run k into heads[k], false at its end
+    bool read_head(int k);
+
+    TableReader reader;
+    long count;
+    bool descending;
+    //true if only the first rows were kept
+    bool topK;
+
+    //the sorted entries, when they fit in memory
+    vector<Entry> entries;
+    size_t pos;
+
+    //every run file written, the runs spilled and the merge passes
+    //made before the last one
+    string runName;
+    vector<string> runFiles;
+    int spilled;
+    int passes;
+    //the runs of the last merge, the first unread entry of each and
+    //the runs ordered by it (a heap, the run to take from next on top)
+    vector<string> left;
+    vector<unique_ptr<fstream>> runs_in;
+    vector<Entry> heads;
+    vector<int> heap;
+    //bytes written to and read back from the runs
+    long runBytes;
+};
+
+#endif // EXECUTOR_H
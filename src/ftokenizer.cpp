@@ -1,24 +1,56 @@
 #include "ftokenizer.h"
+#include <cstring>
+
+#if !defined(__EMSCRIPTEN__) && !defined(_WIN32)
+#define FTOKENIZER_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 FTokenizer::FTokenizer(string fname)
+    : _base(nullptr), _mapSize(0), _filled(0), _pos(0), _blockPos(0),
+      _more(true)
 {
     //opens file declares _f to be an input stream for it
     if(debug){cout << fname << endl;}
     if(fname.find('.') > fname.size())
         fname += ".txt";
-    _f.open(fname);
-    if(_f.fail())
-        throw error("File does not exist");
-    else
+
+#ifdef FTOKENIZER_MMAP
+    int fd = open(fname.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd >= 0 && fstat(fd, &st) == 0 && st.st_size > 0)
     {
-        if(debug){cout << fname<< " was opened\n";}
+        void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED)
+        {
+            _base = static_cast<const char *>(p);
+            _mapSize = st.st_size;
+            madvise(p, _mapSize, MADV_SEQUENTIAL);
+        }
     }
+    // the mapping stays valid after the descriptor is closed
+    if (fd >= 0)
+        close(fd);
+#endif
 
-    //initializes member variables
-    _more = (!_f.eof());
-    _blockPos = 0;
-    _pos = 0;
-    _stk = STokenizer();
+    if(!_base)
+    {
+        _f.open(fname, std::ifstream::in | std::ifstream::binary);
+        if(_f.fail())
+            throw error("File does not exist");
+    }
+    if(debug){cout << fname<< " was opened\n";}
+}
+
+FTokenizer::~FTokenizer()
+{
+#ifdef FTOKENIZER_MMAP
+    if (_base)
+        munmap(const_cast<char *>(_base), _mapSize);
+#endif
 }
 
 //grabs next token in file
@@ -35,12 +67,12 @@ bool FTokenizer::more()
     return _more;
 }
 
-int FTokenizer::pos()
+long FTokenizer::pos()
 {
     return _pos;
 }
 
-int FTokenizer::block_pos()
+long FTokenizer::block_pos()
 {
     return _blockPos;
 }
@@ -64,45 +96,65 @@ FTokenizer& operator >> (FTokenizer& f, Token& t)
     return f;
 }
 
-
-bool FTokenizer::get_new_block()
+bool FTokenizer::next_line(string_view& line)
 {
-    //check if file is empty
-    if(!_f.eof())
+    while(block_done())
     {
-        //grabs 500 tokens
-        char s[MAX_BUFFER];
-        _f.read(s, MAX_BUFFER);
-        //if no tokens were grabbed return false
-        if(_f.gcount() == 0)
-            return false;
-
-        //if we were only to semi fill the char array,
-        //mark the terminating null at the appropriate position
-        //and fill _stk using set string function
-        if(!_f)
+        if(!get_new_block())
         {
-            if(debug)
-            {
-                cout << "we were only able to get " << _f.gcount() << endl;
-            }
-            s[_f.gcount()] = '\0';
-            _stk.set_string(s);
+            _more = false;
+            return false;
         }
+    }
 
-        //mark the terminating null and fill _stk using the set string
-        //function
-        if(debug){cout << s << endl;}
-        s[MAX_BUFFER-1] = '\0';
-        _stk.set_string(s);
-
-        return true;
+    const char* start = _block.data() + _blockPos;
+    size_t left = _block.size() - _blockPos;
+    const char* end = static_cast<const char*>(memchr(start, '\n', left));
+    size_t length = end ? end - start : left;
+    line = string_view(start, length);
+    _blockPos += end ? length + 1 : length;
+    return true;
+}
 
+bool FTokenizer::get_new_block()
+{
+    //the mapping is one block
+    if(_base)
+    {
+        if(_pos >= _mapSize)
+            return false;
+        _block = string_view(_base, _mapSize);
     }
-    //return false if file is empty
     else
     {
-        return false;
+        if(!_f)
+            return false;
+
+        //grabs MAX_BLOCK chars into the buffer the block before the
+        //current one was in
+        _filled = 1 - _filled;
+        string& buffer = _buffers[_filled];
+        buffer.resize(MAX_BLOCK);
+        _f.read(&buffer[0], MAX_BLOCK);
+        //if no chars were grabbed return false
+        if(_f.gcount() == 0)
+            return false;
+        buffer.resize(_f.gcount());
+
+        //and the rest of the last line
+        string rest;
+        if(buffer.back() != '\n' && getline(_f, rest))
+        {
+            buffer += rest;
+            if(!_f.eof())
+                buffer += '\n';
+        }
+        _block = buffer;
     }
 
+    if(debug){cout << _block << endl;}
+    _pos += _block.size();
+    _blockPos = 0;
+    _stk.set_string(_block);
+    return true;
 }
@@ -6,28 +6,41 @@
 
 using namespace std;
 
+/*
+ * An FTokenizer hands out the tokens or the lines of a file, a block at
+ * a time. A block ends at the end of a line, so no line or token is cut
+ * between two blocks. Tokens and lines are views into their block.
+ *
+ * Where the platform has mmap the whole file is mapped and is the one
+ * block. Otherwise blocks of MAX_BLOCK chars (and the rest of their last
+ * line) are read into two buffers in turn: a block stays good while the
+ * one after it is read, and goes when the one after that is.
+ */
 class FTokenizer
 {
 public:
-    //each block holds up to 500 chars
-    const int MAX_BLOCK = MAX_BUFFER;
+    //each block holds about this many chars
+    static const int MAX_BLOCK = 1 << 16;
 
     //Precondition: fname is the name of a file
-    //Postcondition: opens file and sets it to input file stream variable
-    //_f.
-    //sets _pos and _blockpos to 0. sets _more to true or false depending
-    //on the file given. Initializes _stk to an empty STokenizer object.
+    //Postcondition: maps or opens the file. sets _pos and _blockPos to
+    //0 and _more to true. nothing has been read yet.
     FTokenizer(string fname);
 
+    ~FTokenizer();
+
+    FTokenizer(const FTokenizer&) = delete;
+    FTokenizer& operator = (const FTokenizer&) = delete;
+
     //Postcondition: returns the next token from STokenizer object _stk
     Token next_token();
 
     //Postcondition: returns the current value of _more
     bool more();
     //returns the value of _pos
-    int pos();
-    //returns the value of _blockpos
-    int block_pos();
+    long pos();
+    //returns the value of _blockPos
+    long block_pos();
 
     //Precondition: the file is not empty and _stk is not empty.
     //If there are still tokens in the file, will call get_new_block
@@ -37,16 +50,34 @@ public:
     //Precondition: Recieves a token from the file and sets it to t
     friend FTokenizer& operator >> (FTokenizer& f, Token& t);
 
+    //Postcondition: line is the next line of the file, without its
+    //'\n'. returns false (and sets _more to false) at the end of the
+    //file. use either the lines or the tokens of a file, not both
+    bool next_line(string_view& line);
+
+    //Postcondition: true if the lines of the current block have all
+    //been handed out, the next line will be in a new block
+    bool block_done() const {return _blockPos >= _block.size();}
+
 private:
     bool get_new_block(); //gets the new block from the file
 
-    std::ifstream _f;   //file being tokenized
+    const char* _base;  //the mapped file, or nullptr if it is read
+    long _mapSize;      //bytes mapped
+
+    std::ifstream _f;   //file being tokenized, when it is not mapped
+
+    string _buffers[2]; //the blocks read from _f, in turn
+
+    int _filled;        //the buffer the current block is in
+
+    string_view _block; //the current block
 
     STokenizer _stk;     //The STokenizer object to tokenize current block
 
-    int _pos;           //Current position in the file
+    long _pos;          //position in the file of the end of the block
 
-    int _blockPos;      //Current position in the current block
+    size_t _blockPos;   //Current position in the current block
 
     bool _more;         //false if last token of the last block
                         //  has been processed and now we are at
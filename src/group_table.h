@@ -0,0 +1,123 @@
+#ifndef GROUP_TABLE_H
+#define GROUP_TABLE_H
+
+#include "mylib.h"
+#include <cstdint>
+#include <functional>
+#include <string_view>
+
+using namespace std;
+
+/*
+ * A GroupTable numbers the distinct keys of a group by (or of the
+ * build side of a hash join), 0, 1, 2, ... in the order they are first
+ * seen, so whatever is kept per key can sit in flat vectors indexed by
+ * group number.
+ *
+ * It is an open addressing hash table with linear probing. A slot is
+ * just the key's hash and its group number, 8 bytes, so a probe walks
+ * a few neighbouring slots of one cache line and only looks at a key
+ * itself when the hashes match. The table doubles before it is half
+ * full.
+ */
+class GroupTable
+{
+public:
+/*
+ * *************************************************************
+ *                       C T O R S
+ * *************************************************************
+*/
+    GroupTable(): slots(16) {}
+
+/*
+ * *************************************************************
+ *              S E A R C H I N G  &  A C C E S S
+ * *************************************************************
+*/
+    //number of distinct keys
+    int size() const {return static_cast<int>(keys.size());}
+
+    //the key of group number group
+    const string& key(int group) const {return keys[group];}
+
+    //the group number of key, -1 if it has not been seen
+    int find(string_view key) const
+    {
+        uint32_t h = hash_of(key);
+        size_t mask = slots.size() - 1;
+        for (size_t i = h & mask; slots[i].group != EMPTY; i = (i + 1) & mask)
+            if (slots[i].hash == h && keys[slots[i].group] == key)
+                return slots[i].group;
+        return EMPTY;
+    }
+
+/*
+ * *************************************************************
+ *              M O D I F I E R     F U N C T I O N S
+ * *************************************************************
+*/
+    //the group number of key. a key not seen before gets the next
+    //number, size() - 1 after the call
+    int insert(string_view key)
+    {
+        uint32_t h = hash_of(key);
+        size_t mask = slots.size() - 1;
+        size_t i = h & mask;
+        for (; slots[i].group != EMPTY; i = (i + 1) & mask)
+            if (slots[i].hash == h && keys[slots[i].group] == key)
+                return slots[i].group;
+
+        if ((keys.size() + 1) * 2 > slots.size())
+        {
+            grow();
+            mask = slots.size() - 1;
+            for (i = h & mask; slots[i].group != EMPTY; i = (i + 1) & mask)
+                ;
+        }
+        slots[i].hash = h;
+        slots[i].group = size();
+        keys.push_back(string(key));
+        return slots[i].group;
+    }
+
+private:
+    static const int EMPTY = -1;
+
+    struct Slot
+    {
+        Slot(): hash(0), group(EMPTY) {}
+        uint32_t hash;
+        int group;
+    };
+
+    static uint32_t hash_of(string_view key)
+    {
+        uint64_t h = std::hash<string_view>()(key);
+        return static_cast<uint32_t>(h ^ (h >> 32));
+    }
+
+    //doubles the slots and puts every group back in
+    void grow()
+    {
+        vector<Slot> old(slots.size() * 2);
+        old.swap(slots);
+        size_t mask = slots.size() - 1;
+        for (size_t k = 0; k < old.size(); ++k)
+        {
+            if (old[k].group == EMPTY)
+                continue;
+            size_t i = old[k].hash & mask;
+            while (slots[i].group != EMPTY)
+                i = (i + 1) & mask;
+            slots[i] = old[k];
+        }
+    }
+
+    //a power of two of slots, EMPTY or a group number
+    vector<Slot> slots;
+    //the key of every group, by group number
+    vector<string> keys;
+};
+
+#endif // GROUP_TABLE_H
@@ -0,0 +1,363 @@
+#include "index_file.h"
+#include "page.h"
+
+// page types
+static const int LEAF_PAGE = 1;
+static const int INTERIOR_PAGE = 2;
+static const int OVERFLOW_PAGE = 3;
+
+// every page starts with: type (1), unused (1), count (2), link (4)
+// link is the next leaf for leaves, child 0 for interior pages and
+// the next overflow page for overflow pages
+static const int PAGE_HEADER = 8;
+
+// leaf entry without its key and inline postings:
+// key length (2), posting count (4), first overflow page (4)
+static const int LEAF_ENTRY = 10;
+
+// interior entry without its key: key length (2), child (4)
+static const int INTERIOR_ENTRY = 6;
+
+static_assert(PAGE_HEADER + LEAF_ENTRY + INDEX_MAX_KEY == INDEX_PAGE_SIZE,
+              "INDEX_MAX_KEY does not match the leaf layout");
+
+static const char MAGIC[8] = {'D', 'S', 'D', 'B', 'I', 'D', 'X', '\0'};
+
+// fills in the common page header
+static void set_header(char page[], int type, int count, int link)
+{
+    page[0] = static_cast<char>(type);
+    page[1] = 0;
+    put16(page + 2, count);
+    put32(page + 4, link);
+}
+
+// writes page to page number pageno
+static void write_page(fstream &out, int pageno, const char page[])
+{
+    out.seekp(static_cast<streamoff>(pageno) * INDEX_PAGE_SIZE, ios_base::beg);
+    out.write(page, INDEX_PAGE_SIZE);
+}
+
+// writes recnos to a chain of overflow pages starting at page number
+// pageCount. returns the first page of the chain
+static int write_overflow(fstream &out, const vector<int> &recnos,
+                          int &pageCount)
+{
+    const int perPage = (INDEX_PAGE_SIZE - PAGE_HEADER) / 4;
+    char page[INDEX_PAGE_SIZE];
+    int first = pageCount;
+
+    for (size_t i = 0; i < recnos.size(); i += perPage)
+    {
+        int n = static_cast<int>(min(recnos.size() - i, size_t(perPage)));
+        int pageno = pageCount++;
+        memset(page, 0, sizeof(page));
+        // last page of the chain links to 0
+        set_header(page, OVERFLOW_PAGE, 0,
+                   i + perPage < recnos.size() ? pageCount : 0);
+        for (int j = 0; j < n; ++j)
+            put32(page + PAGE_HEADER + 4 * j, recnos[i + j]);
+        write_page(out, pageno, page);
+    }
+    return first;
+}
+
+IndexFile::IndexFile(string name)
+    : filename(name), valid(false), root(0), firstLeaf(0),
+      keyCount(0), recordCount(0), pagesRead(0)
+{
+    f.open(filename, std::fstream::in | std::fstream::binary);
+    if (f.fail())
+        return;
+
+    char page[INDEX_PAGE_SIZE];
+    f.read(page, INDEX_PAGE_SIZE);
+    pagesRead++;
+    if (f.gcount() != INDEX_PAGE_SIZE ||
+        memcmp(page, MAGIC, sizeof(MAGIC)) != 0 ||
+        get32(page + 8) != INDEX_VERSION ||
+        get32(page + 12) != INDEX_PAGE_SIZE)
+    {
+        // not an index file we understand, treat it as missing
+        f.close();
+        return;
+    }
+    root = get32(page + 16);
+    firstLeaf = get32(page + 20);
+    keyCount = get32(page + 28);
+    recordCount = get32(page + 32);
+    valid = true;
+}
+
+// reads page number pageno into page
+void IndexFile::read_page(int pageno, char page[])
+{
+    f.clear();
+    f.seekg(static_cast<streamoff>(pageno) * INDEX_PAGE_SIZE, ios_base::beg);
+    f.read(page, INDEX_PAGE_SIZE);
+    pagesRead++;
+    if (f.gcount() != INDEX_PAGE_SIZE)
+        throw error("Index file is corrupt");
+}
+
+// copies the posting list of one leaf entry into recnos
+void IndexFile::read_postings(const char page[], int pos, int count,
+                              int overflow, vector<int> &recnos)
+{
+    recnos.clear();
+    recnos.reserve(count);
+
+    // short lists live right after the entry
+    if (overflow == 0)
+    {
+        for (int i = 0; i < count; ++i)
+            recnos.push_back(get32(page + pos + 4 * i));
+        return;
+    }
+
+    // long lists live in a chain of overflow pages
+    const int perPage = (INDEX_PAGE_SIZE - PAGE_HEADER) / 4;
+    char chain[INDEX_PAGE_SIZE];
+    int pageno = overflow;
+    while (pageno != 0 && static_cast<int>(recnos.size()) < count)
+    {
+        read_page(pageno, chain);
+        int n = min(count - static_cast<int>(recnos.size()), perPage);
+        for (int i = 0; i < n; ++i)
+            recnos.push_back(get32(chain + PAGE_HEADER + 4 * i));
+        pageno = get32(chain + 4);
+    }
+}
+
+// descends from the root to the leaf that would hold key
+bool IndexFile::find(const string &key, vector<int> &recnos)
+{
+    if (!valid || root == 0)
+        return false;
+
+    char page[INDEX_PAGE_SIZE];
+    int pageno = root;
+    read_page(pageno, page);
+
+    // interior pages: follow the last separator that is <= key
+    while (page[0] == INTERIOR_PAGE)
+    {
+        int count = get16(page + 2);
+        int child = get32(page + 4);
+        int pos = PAGE_HEADER;
+        for (int i = 0; i < count; ++i)
+        {
+            int len = get16(page + pos);
+            string sep(page + pos + 2, len);
+            if (key < sep)
+                break;
+            child = get32(page + pos + 2 + len);
+            pos += INTERIOR_ENTRY + len;
+        }
+        pageno = child;
+        read_page(pageno, page);
+    }
+
+    // leaf page: look for the key itself
+    int count = get16(page + 2);
+    int pos = PAGE_HEADER;
+    for (int i = 0; i < count; ++i)
+    {
+        int len = get16(page + pos);
+        int postings = get32(page + pos + 2 + len);
+        int overflow = get32(page + pos + 6 + len);
+        if (key.compare(0, string::npos, page + pos + 2, len) == 0)
+        {
+            read_postings(page, pos + LEAF_ENTRY + len, postings,
+                          overflow, recnos);
+            return true;
+        }
+        pos += LEAF_ENTRY + len + (overflow == 0 ? 4 * postings : 0);
+    }
+    return false;
+}
+
+// reads every leaf, left to right, then builds index from the entries,
+// which come out of the file already sorted
+void IndexFile::load(MMap<string, int> &index)
+{
+    if (!valid)
+        return;
+
+    char page[INDEX_PAGE_SIZE];
+    vector<MPair<string, int>> entries;
+    entries.reserve(keyCount);
+    vector<int> recnos;
+    int pageno = firstLeaf;
+    while (pageno != 0)
+    {
+        read_page(pageno, page);
+        int count = get16(page + 2);
+        int pos = PAGE_HEADER;
+        for (int i = 0; i < count; ++i)
+        {
+            int len = get16(page + pos);
+            entries.push_back(MPair<string, int>(string(page + pos + 2, len)));
+            int postings = get32(page + pos + 2 + len);
+            int overflow = get32(page + pos + 6 + len);
+            read_postings(page, pos + LEAF_ENTRY + len, postings,
+                          overflow, recnos);
+            entries.back().value_list.assign(recnos);
+            entries.back().value_list.shrink_to_fit();
+            pos += LEAF_ENTRY + len + (overflow == 0 ? 4 * postings : 0);
+        }
+        pageno = get32(page + 4);
+    }
+    index.build(entries);
+}
+
+// writes the whole index bottom up: leaves first, in key order, then
+// one level of interior pages at a time until a single root is left
+static void write_index(fstream &out, MMap<string, int> &index,
+                        int record_count)
+{
+    char page[INDEX_PAGE_SIZE];
+    int pageCount = 1; // page 0 is the header
+    int keys = 0;
+
+    // (first key, page number) of every node in the level being built
+    vector<pair<string, int>> level;
+
+    int leaf = 0;
+    int pos = PAGE_HEADER;
+    int count = 0;
+    for (MMap<string, int>::Iterator it = index.begin();
+         it != index.end(); it++)
+    {
+        const MPair<string, int> &entry = *it;
+        const string &key = entry.key;
+        const PostingList &recnos = entry.value_list;
+        int len = static_cast<int>(key.size());
+        if (len > INDEX_MAX_KEY)
+            throw error("Index key too long");
+
+        // keep the postings inline if the entry fits in a page
+        bool inlined = PAGE_HEADER + LEAF_ENTRY + len +
+                           4 * static_cast<long>(recnos.size()) <=
+                       INDEX_PAGE_SIZE;
+        int size = LEAF_ENTRY + len +
+                   (inlined ? 4 * static_cast<int>(recnos.size()) : 0);
+
+        // start a new leaf if this one is full
+        if (leaf == 0 || pos + size > INDEX_PAGE_SIZE)
+        {
+            int next = pageCount++;
+            if (leaf != 0)
+            {
+                set_header(page, LEAF_PAGE, count, next);
+                write_page(out, leaf, page);
+            }
+            memset(page, 0, sizeof(page));
+            leaf = next;
+            pos = PAGE_HEADER;
+            count = 0;
+            level.push_back(make_pair(key, leaf));
+        }
+
+        int overflow = inlined ? 0 : write_overflow(out, recnos.to_vector(),
+                                                    pageCount);
+        put16(page + pos, len);
+        memcpy(page + pos + 2, key.data(), len);
+        put32(page + pos + 2 + len, static_cast<int>(recnos.size()));
+        put32(page + pos + 6 + len, overflow);
+        pos += LEAF_ENTRY + len;
+        if (inlined)
+        {
+            for (int recno : recnos)
+            {
+                put32(page + pos, recno);
+                pos += 4;
+            }
+        }
+        count++;
+        keys++;
+    }
+    if (leaf != 0)
+    {
+        set_header(page, LEAF_PAGE, count, 0);
+        write_page(out, leaf, page);
+    }
+    int firstLeaf = level.empty() ? 0 : level[0].second;
+
+    // interior levels: child 0 lives in the page header, every
+    // other child is preceded by its first key
+    while (level.size() > 1)
+    {
+        vector<pair<string, int>> upper;
+        int node = 0;
+        for (size_t i = 0; i < level.size(); ++i)
+        {
+            int len = static_cast<int>(level[i].first.size());
+            if (node == 0 || pos + INTERIOR_ENTRY + len > INDEX_PAGE_SIZE)
+            {
+                if (node != 0)
+                    write_page(out, node, page);
+                node = pageCount++;
+                memset(page, 0, sizeof(page));
+                set_header(page, INTERIOR_PAGE, 0, level[i].second);
+                pos = PAGE_HEADER;
+                count = 0;
+                upper.push_back(make_pair(level[i].first, node));
+                continue;
+            }
+            put16(page + pos, len);
+            memcpy(page + pos + 2, level[i].first.data(), len);
+            put32(page + pos + 2 + len, level[i].second);
+            pos += INTERIOR_ENTRY + len;
+            put16(page + 2, ++count);
+        }
+        write_page(out, node, page);
+        level = upper;
+    }
+    int root = level.empty() ? 0 : level[0].second;
+
+    // header page
+    memset(page, 0, sizeof(page));
+    memcpy(page, MAGIC, sizeof(MAGIC));
+    put32(page + 8, INDEX_VERSION);
+    put32(page + 12, INDEX_PAGE_SIZE);
+    put32(page + 16, root);
+    put32(page + 20, firstLeaf);
+    put32(page + 24, pageCount);
+    put32(page + 28, keys);
+    put32(page + 32, record_count);
+    write_page(out, 0, page);
+}
+
+void IndexFile::save(const string &name, MMap<string, int> &index,
+                     int record_count)
+{
+    // write to a scratch file and rename it over the old index, so a
+    // failed save never leaves a half written index behind
+    string tmpName = name + ".tmp";
+    fstream out(tmpName, std::fstream::out | std::fstream::binary |
+                             std::fstream::trunc);
+    if (out.fail())
+        throw error("Could not write index file");
+
+    try
+    {
+        write_index(out, index, record_count);
+    }
+    catch (...)
+    {
+        out.close();
+        remove(tmpName.c_str());
+        throw;
+    }
+    out.close();
+    if (out.fail())
+    {
+        remove(tmpName.c_str());
+        throw error("Could not write index file");
+    }
+    remove(name.c_str());
+    if (rename(tmpName.c_str(), name.c_str()) != 0)
+        throw error("Could not write index file");
+}
@@ -0,0 +1,112 @@
+#ifndef INDEX_FILE_H
+#define INDEX_FILE_H
+
+#include "mylib.h"
+#include "mmap.h"
+#include "error.h"
+
+using namespace std;
+
+//size of every page in an index file
+const int INDEX_PAGE_SIZE = 4096;
+
+//longest key an index file can hold: one leaf entry (10 bytes and
+//the key) has to fit in a page after its header (8 bytes)
+const int INDEX_MAX_KEY = INDEX_PAGE_SIZE - 18;
+
+//bumped whenever the on disk layout changes
+const int INDEX_VERSION = 1;
+
+/*
+ * An IndexFile is the on disk copy of one column index (an
+ * MMap<string, int> of field value -> record numbers).
+ *
+ * The file is a B+tree made of fixed size pages:
+ *   page 0        header (magic, version, root, first leaf, counts)
+ *   leaf pages    sorted (key, posting list) entries, linked by next
+ *   interior      separator keys and child page numbers
+ *   overflow      record numbers of posting lists too big for a leaf
+ *
+ * The header remembers how many records of the table the index
+ * covers. Records appended after that are picked up by the table
+ * replaying the tail of its .bin file, so the index file only has to
+ * be rewritten when the table is closed.
+ */
+class IndexFile
+{
+public:
+/*
+ * *************************************************************
+ *                       C T O R
+ * *************************************************************
+*/
+    //opens the index file called name (it may not exist yet)
+    IndexFile(string name);
+
+/*
+ * *************************************************************
+ *              R E A D    F U N C T I O N S
+ * *************************************************************
+*/
+    //true if the file exists and has a valid header
+    bool exists() const {return valid;}
+    //number of table records this index covers
+    int record_count() const {return recordCount;}
+    //number of distinct keys in the index
+    int key_count() const {return keyCount;}
+    //bytes of the pages read so far, the header included
+    long bytes_read() const {return pagesRead * INDEX_PAGE_SIZE;}
+
+    //walks from the root down to one leaf and copies the posting
+    //list of key into recnos. returns false if key is not indexed
+    bool find(const string& key, vector<int>& recnos);
+
+    //reads every leaf into index, replacing what it held
+    void load(MMap<string, int>& index);
+
+/*
+ * *************************************************************
+ *              W R I T E    F U N C T I O N S
+ * *************************************************************
+*/
+    //writes index to the file called name, replacing it.
+    //record_count is the number of table records the index covers
+    static void save(const string& name, MMap<string, int>& index,
+                     int record_count);
+
+private:
+/*
+ * *************************************************************
+ *            P R I V A T E     F U N C T I O N S
+ * *************************************************************
+*/
+    //reads page number pageno into page
+    void read_page(int pageno, char page[]);
+    //copies the posting list of the entry at pos into recnos
+    void read_postings(const char page[], int pos, int count,
+                       int overflow, vector<int>& recnos);
+
+/*
+ * *************************************************************
+ *            P R I V A T E     V A R I A B L E S
+ * *************************************************************
+*/
+    //the index file
+    fstream f;
+    //name of the index file
+    string filename;
+    //true if the header was read successfully
+    bool valid;
+    //page number of the root (0 if the index is empty)
+    int root;
+    //page number of the leftmost leaf (0 if the index is empty)
+    int firstLeaf;
+    //distinct keys in the index
+    int keyCount;
+    //table records the index covers
+    int recordCount;
+    //pages read, for explain analyze
+    long pagesRead;
+};
+
+#endif // INDEX_FILE_H
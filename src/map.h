@@ -7,12 +7,13 @@
 
 using namespace std;
 
-template <typename K, typename V>
+// MIN sets the node size of the underlying BPlusTree
+template <typename K, typename V, int MIN = bplustree_minimum<Pair<K, V>>()>
 class Map
 {
 public:
 
-    typedef BPlusTree<Pair<K, V> > map_base;
+    typedef BPlusTree<Pair<K, V>, MIN> map_base;
 /*
  * *************************************************************
  *          N E S T E D     I T E R A T O R     C L A S S
@@ -27,12 +28,19 @@ public:
             Iterator(typename map_base::Iterator it)
                 :_it(it){}
 
-            //overloaded dereference operator
-            Pair<K, V> operator *()
+            //overloaded dereference operator. returns the pair in
+            //the tree, not a copy
+            const Pair<K, V>& operator *() const
             {
                 return *_it;
             }
 
+            //overloaded member access operator
+            const Pair<K, V>* operator ->() const
+            {
+                return &*_it;
+            }
+
             //overloaded incrementation operator
             Iterator operator++(int un_used)
             {
@@ -71,7 +79,24 @@ public:
     Map()
     {
         key_count = 0;
-        map = BPlusTree<Pair<K,V> >();
+    }
+
+    Map(const Map& other) = default;
+    Map& operator =(const Map& RHS) = default;
+
+    //Move constructor, takes the tree of other
+    Map(Map&& other) noexcept
+        :key_count(other.key_count), map(std::move(other.map))
+    {
+        other.key_count = 0;
+    }
+
+    Map& operator =(Map&& RHS) noexcept
+    {
+        key_count = RHS.key_count;
+        map = std::move(RHS.map);
+        RHS.key_count = 0;
+        return *this;
     }
 
 /*
@@ -145,7 +170,7 @@ public:
  * *************************************************************
 */
     friend ostream& operator<<(ostream& outs,
-                               const Map<K, V>& print_me)
+                               const Map& print_me)
     {
         outs<<print_me.map<<endl;
         return outs;
@@ -164,14 +189,16 @@ public:
         return Iterator(NULL);
     }
 
-    Iterator lower_bound(string startingKey)
+    //first pair whose key is not less than key
+    Iterator lower_bound(const K& key)
     {
-        return map.find(startingKey);
+        return map.lower_bound(Pair<K, V>(key));
     }
 
-    Iterator upper_bound(string endingKey)
+    //first pair whose key is greater than key
+    Iterator upper_bound(const K& key)
     {
-        return ++map.find(endingKey);
+        return map.upper_bound(Pair<K, V>(key));
     }
 /*
  * *************************************************************
@@ -196,7 +223,7 @@ private:
     //amount of keys in map
     int key_count;
     //out map variable made of a BTree
-    BPlusTree<Pair<K, V> > map;
+    map_base map;
 
 };
 #endif // MAP_H
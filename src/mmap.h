@@ -8,11 +8,12 @@
 
 using namespace std;
 
-template <typename K, typename V>
+// MIN sets the node size of the underlying BPlusTree
+template <typename K, typename V, int MIN = bplustree_minimum<MPair<K, V>>()>
 class MMap
 {
 public:
-    typedef BPlusTree<MPair<K, V>> map_base;
+    typedef BPlusTree<MPair<K, V>, MIN> map_base;
     /*
      * *************************************************************
      *          N E S T E D     I T E R A T O R     C L A S S
@@ -27,12 +28,19 @@ public:
         Iterator(typename map_base::Iterator it)
             : _it(it) {}
 
-        // overloaded dereference operator
-        MPair<K, V> operator*()
+        // overloaded dereference operator. returns the pair in the
+        // tree, so its value_list is not copied
+        const MPair<K, V> &operator*() const
         {
             return *_it;
         }
 
+        // overloaded member access operator
+        const MPair<K, V> *operator->() const
+        {
+            return &*_it;
+        }
+
         // overloaded incrementation operator
         Iterator operator++(int un_used)
         {
@@ -63,6 +71,9 @@ public:
     private:
         typename map_base::Iterator _it;
     };
+
+    // goes from the largest key to the smallest
+    typedef typename map_base::ReverseIterator ReverseIterator;
     /*
      * *************************************************************
      *                  C O N S T R U C T O R
@@ -70,7 +81,6 @@ public:
      */
     MMap()
     {
-        mmap = BPlusTree<MPair<K, V>>();
     }
 
     ~MMap()
@@ -98,6 +108,16 @@ public:
         return *this; // Return *this for chaining
     }
 
+    // Move constructor, takes the tree of other
+    MMap(MMap &&other) noexcept
+        : mmap(std::move(other.mmap)) {}
+
+    MMap &operator=(MMap &&RHS) noexcept
+    {
+        mmap = std::move(RHS.mmap);
+        return *this;
+    }
+
     /*
      * *************************************************************
      *                      C A P A C I T Y
@@ -113,7 +133,7 @@ public:
     int size() const { return mmap.size(); }
     // Postcondition: reuturns true if mmap is empty
     //(if key_count is equal to 0)
-    bool empty() const { return mmap.size() == 0; }
+    bool empty() const { return mmap.empty(); }
 
     /*
      * *************************************************************
@@ -124,7 +144,7 @@ public:
     // const overloaded access function to return value
     //(if value is not found in map, should crash?)
     // cout << test[0];
-    const vector<V> &operator[](const K &key) const
+    const typename MPair<K, V>::list_type &operator[](const K &key) const
     {
         return mmap.get(MPair<K, V>(key, V())).value_list;
     }
@@ -132,7 +152,7 @@ public:
     // Postcondition: Returns value from key
     // we can change values using this one
     // test[0] += 12;
-    vector<V> &operator[](const K &key)
+    typename MPair<K, V>::list_type &operator[](const K &key)
     {
         return mmap.get(MPair<K, V>(key, V())).value_list;
     }
@@ -141,7 +161,7 @@ public:
     {
         return mmap.contains(key);
     }
-    vector<V> &get(const K &key)
+    typename MPair<K, V>::list_type &get(const K &key)
     {
         return mmap.get(key);
     }
@@ -157,6 +177,20 @@ public:
         mmap.insert(MPair<K, V>(k, v));
     }
 
+    // replaces the contents of the mmap with pairs, which must be
+    // sorted by key with no key twice. pairs is left empty
+    void build(vector<MPair<K, V>> &pairs)
+    {
+        mmap.build(pairs);
+    }
+
+    // moves every pair, in key order, to the back of pairs and
+    // leaves the mmap empty
+    void flatten(vector<MPair<K, V>> &pairs)
+    {
+        mmap.flatten(pairs);
+    }
+
     // erases an item from BPlusTree
     void erase(const K &key)
     {
@@ -174,7 +208,7 @@ public:
      * *************************************************************
      */
     friend ostream &operator<<(ostream &outs,
-                               const MMap<K, V> &print_me)
+                               const MMap &print_me)
     {
         outs << print_me.mmap << endl;
         return outs;
@@ -195,16 +229,27 @@ public:
         return Iterator(NULL);
     }
 
-    // returns iterator for given key
-    Iterator lower_bound(string startingKey)
+    // begins at the largest key
+    ReverseIterator rbegin()
+    {
+        return mmap.rbegin();
+    }
+    ReverseIterator rend()
+    {
+        return mmap.rend();
+    }
+
+    // returns iterator to the first pair whose key is not less
+    // than key
+    Iterator lower_bound(const K &key)
     {
-        return mmap.find(startingKey);
+        return mmap.lower_bound(MPair<K, V>(key));
     }
 
-    // returns iterator for given key
-    Iterator upper_bound(string endingKey)
+    // returns iterator to the first pair whose key is greater than key
+    Iterator upper_bound(const K &key)
     {
-        return ++mmap.find(endingKey);
+        return mmap.upper_bound(MPair<K, V>(key));
     }
 
     /*
@@ -229,6 +274,6 @@ public:
 
 private:
     // our mmap variable made of a BPlusTree
-    BPlusTree<MPair<K, V>> mmap;
+    map_base mmap;
 };
 #endif // MMAP_H
@@ -1,9 +1,25 @@
 #ifndef MPAIR_H
 #define MPAIR_H
 #include "mylib.h"
+#include "arrayfunctions.h"
+#include "posting_list.h"
 
 using namespace std;
 
+// the container an MPair keeps its values in. record numbers (int
+// values) are kept in a compressed PostingList
+template <typename V>
+struct MPairList
+{
+    typedef vector<V> type;
+};
+
+template <>
+struct MPairList<int>
+{
+    typedef PostingList type;
+};
+
 // Forward declarations to fix -Wnon-template-friend:
 template <typename K, typename V>
 struct MPair;
@@ -14,36 +30,35 @@ MPair<K, V> operator+(const MPair<K, V> &lhs, const MPair<K, V> &rhs);
 template <typename K, typename V>
 struct MPair
 {
+    typedef typename MPairList<V>::type list_type;
+
     K key;
-    vector<V> value_list;
+    list_type value_list;
 
     MPair(const K &k = K())
     {
         key = k;
-        value_list = vector<V>();
     }
 
     MPair(const K &k, const V &v)
     {
         (void)v; // fixes -Wunused-parameter
         key = k;
-        value_list = vector<V>();
         // value_list.push_back(v);
     }
 
     MPair(const K &k, const vector<V> &vlist)
     {
         key = k;
-        value_list = vector<V>();
         value_list = vlist;
     }
 
     friend ostream &operator<<(ostream &outs,
                                const MPair<K, V> &print_me)
     {
-        for (size_t i = 0; i < print_me.value_list.size(); ++i) // fixes -Wsign-compare
+        for (const V &value : print_me.value_list)
         {
-            outs << print_me.value_list[i] << " ";
+            outs << value << " ";
         }
         return outs;
     }
@@ -103,7 +118,7 @@ struct MPair
                                   const MPair<K, V> &rhs)
     {
         MPair<K, V> temp = lhs;
-        temp.value_list += rhs.value_list[0];
+        temp.value_list.push_back(*rhs.value_list.begin());
         return temp;
     }
 };
@@ -0,0 +1,112 @@
+#ifndef NODE_POOL_H
+#define NODE_POOL_H
+
+#include "mylib.h"
+#include <new>
+
+using namespace std;
+
+/*
+ * A NodePool hands out memory for the nodes of one tree. Nodes are
+ * carved out of slabs, so the nodes of a tree sit next to each other
+ * in memory instead of wherever malloc put them, and there is one
+ * allocation per slab instead of one per node. Slabs start small and
+ * double up to MAX_SLAB nodes, so a tree of a few nodes stays small.
+ *
+ * A node given back with release() is reused by the next allocate().
+ * reset() gives back every node at once by rewinding to the start of
+ * the first slab; the caller must have destroyed the nodes first. The
+ * slabs are kept for the next nodes and freed with the pool.
+ */
+template <class Node>
+class NodePool
+{
+public:
+/*
+ * *************************************************************
+ *                    C T O R  /  D T O R
+ * *************************************************************
+*/
+    NodePool(): free_list(NULL), current(0), used(0) {}
+    ~NodePool()
+    {
+        for (size_t i = 0; i < slabs.size(); ++i)
+            ::operator delete(slabs[i]);
+    }
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator =(const NodePool&) = delete;
+
+/*
+ * *************************************************************
+ *                   A L L O C A T I O N
+ * *************************************************************
+*/
+    //memory for one node. the node still has to be constructed
+    void* allocate()
+    {
+        // reuse a released node first
+        if (free_list)
+        {
+            Slot* slot = free_list;
+            free_list = slot->next;
+            return slot;
+        }
+        // move on to the next slab when this one is full, making it
+        // if the pool has never been this big
+        if (current == slabs.size() || used == slab_size(current))
+        {
+            if (current < slabs.size())
+                ++current;
+            if (current == slabs.size())
+                slabs.push_back(static_cast<char*>(
+                    ::operator new(sizeof(Node) * slab_size(current))));
+            used = 0;
+        }
+        return slabs[current] + sizeof(Node) * used++;
+    }
+
+    //gives back the memory of one node, which must be destroyed
+    void release(void* node)
+    {
+        Slot* slot = static_cast<Slot*>(node);
+        slot->next = free_list;
+        free_list = slot;
+    }
+
+    //gives back every node
+    void reset()
+    {
+        free_list = NULL;
+        current = 0;
+        used = 0;
+    }
+
+private:
+    //nodes in the first slab and the most in any slab
+    static constexpr int MIN_SLAB = 4;
+    static constexpr int MAX_SLAB = 64;
+
+    //a released node is reused to link the free list
+    struct Slot
+    {
+        Slot* next;
+    };
+    static_assert(sizeof(Node) >= sizeof(Slot), "node too small to pool");
+
+    //nodes in slab k: MIN_SLAB, doubling up to MAX_SLAB
+    static int slab_size(size_t k)
+    {
+        return k < 4 ? MIN_SLAB << k : MAX_SLAB;
+    }
+
+    //every slab allocated so far
+    vector<char*> slabs;
+    //released nodes
+    Slot* free_list;
+    //the slab being filled, and the nodes handed out from it
+    size_t current;
+    int used;
+};
+
+#endif // NODE_POOL_H
@@ -0,0 +1,36 @@
+#ifndef PAGE_H
+#define PAGE_H
+
+#include <cstdint>
+#include <cstring>
+
+//helpers to move integers in and out of page buffers. values are
+//stored in the byte order of the machine (little endian for wasm)
+
+inline void put16(char *p, int v)
+{
+    uint16_t x = static_cast<uint16_t>(v);
+    memcpy(p, &x, sizeof(x));
+}
+
+inline void put32(char *p, int v)
+{
+    uint32_t x = static_cast<uint32_t>(v);
+    memcpy(p, &x, sizeof(x));
+}
+
+inline int get16(const char *p)
+{
+    uint16_t x;
+    memcpy(&x, p, sizeof(x));
+    return x;
+}
+
+inline int get32(const char *p)
+{
+    uint32_t x;
+    memcpy(&x, p, sizeof(x));
+    return static_cast<int>(x);
+}
+
+#endif // PAGE_H
@@ -1,38 +1,48 @@
 #include "parser.h"
+#include "arrayfunctions.h"
 #include <cctype> // <-- ADDED (for std::isspace)
 
+// s without its parentheses and commas
+static string without_parens(string_view s)
+{
+    string bare;
+    for (size_t i = 0; i < s.size(); ++i)
+        if (s[i] != '(' && s[i] != ')' && s[i] != ',')
+            bare += s[i];
+    return bare;
+}
+
 Parser::Parser()
 {
-    initKeys();
-    makeTable();
 }
 
-Parser::Parser(char *phrase)
+Parser::Parser(string_view phrase)
 {
     bool debug = false;
     string temp2 = "";
     bool comma = false;
-
-    // make our table
-    makeTable();
+    // the token before was a word, and the one before that a word and
+    // a . or a : (the char, 0 if not)
+    bool afterWord = false;
+    char joiner = 0;
 
     // --- FIX: allow batch filenames like FinalTest or FinalTest.txt or examples/FinalTest.txt (and quoted paths) ---
     {
-        std::string original = phrase ? std::string(phrase) : std::string();
+        string_view original = phrase;
 
-        auto ltrim = [](std::string &s)
+        auto ltrim = [](string_view &s)
         {
             size_t i = 0;
             while (i < s.size() && std::isspace(static_cast<unsigned char>(s[i])))
                 i++;
-            s.erase(0, i);
+            s.remove_prefix(i);
         };
-        auto rtrim = [](std::string &s)
+        auto rtrim = [](string_view &s)
         {
             size_t i = s.size();
             while (i > 0 && std::isspace(static_cast<unsigned char>(s[i - 1])))
                 i--;
-            s.erase(i);
+            s.remove_suffix(s.size() - i);
         };
 
         ltrim(original);
@@ -41,7 +51,7 @@ Parser::Parser(char *phrase)
         if (original.rfind("batch", 0) == 0 &&
             (original.size() == 5 || std::isspace(static_cast<unsigned char>(original[5]))))
         {
-            std::string fname = original.substr(5); // everything after 'batch'
+            string_view fname = original.substr(5); // everything after 'batch'
             ltrim(fname);
             rtrim(fname);
 
@@ -54,10 +64,9 @@ Parser::Parser(char *phrase)
 
             commands.clear();
             commands.push_back("batch");
-            commands.push_back(fname);
+            commands.push_back(string(fname));
 
-            initKeys();
-            setMMap();
+            setStatement();
             return;
         }
     }
@@ -71,10 +80,22 @@ Parser::Parser(char *phrase)
         Token temp = Token();
         // grab a token
         stk >> temp;
-        if (temp.token_str() != " " && temp.token_str() != "," && temp.token_str() != "\t")
+        string_view text = temp.token_str();
+        if (text != " " && text != "," && text != "\t")
             comma = false;
+        // a.x comes out of the tokenizer as a . x, and salary:int as
+        // salary : int, put them back together
+        if (joiner && temp.type() == ALPHA_TOKEN)
+        {
+            commands.back() += joiner;
+            commands.back() += text;
+            joiner = 0;
+            continue;
+        }
+        joiner = afterWord && (text == "." || text == ":") ? text[0] : 0;
+        afterWord = temp.type() == ALPHA_TOKEN;
         // clear quotatoion marks
-        if (temp.token_str() == "\"" && stk.more())
+        if (text == "\"" && stk.more())
         {
             stk >> temp;
             while (temp.token_str()[0] != '\"' && stk.more())
@@ -84,30 +105,26 @@ Parser::Parser(char *phrase)
             }
             commands.push_back(temp2);
             temp2.clear();
+            text = temp.token_str();
         }
-        if (temp.token_str() == ",")
+        if (text == ",")
             comma = true;
-        else if (temp.token_str() == "*" || temp.token_str() == "<" ||
-                 temp.token_str() == "=" ||
-                 temp.token_str() == ">" ||
-                 temp.token_str() == "<=" ||
-                 temp.token_str() == ">=" ||
-                 temp.type_string() == "ALPHA" || temp.type_string() == "NUMBER")
-            commands.push_back(temp.token_str());
+        else if (text == "*" || text == "<" || text == "=" || text == ">" ||
+                 text == "<=" || text == ">=" ||
+                 temp.type() == ALPHA_TOKEN || temp.type() == NUMBER_TOKEN)
+            commands.push_back(string(text));
+        // count(*) comes out of the tokenizer as count and (*)
+        else if (temp.type() == PUNCT_TOKEN && without_parens(text) == "*")
+            commands.push_back("*");
     }
 
     // if no value after comma
     if (comma)
         throw error("Error: Missing value after comma");
 
-    // initialize keywords to values in
-    // if command is not found in indices, give the
-    // value of symbol
-    initKeys();
-
     // Setup parse tree
     // organizes tokens
-    setMMap();
+    setStatement();
 
     if (debug)
     {
@@ -122,109 +139,250 @@ Parser::Parser(char *phrase)
         }
         cout << endl;
 
-        // MMAP
+        // STATEMENT
         cout << "PARSE_TREE" << endl;
-        cout << "Commands: " << parse_tree["command"] << endl;
-        cout << "table name: " << parse_tree["table_name"] << endl;
-        cout << "fields " << parse_tree["fields"] << endl;
-        cout << "values " << parse_tree["values"] << endl;
-        cout << "relational" << parse_tree["relational"] << endl;
-        cout << "logical" << parse_tree["logical"] << endl;
-        cout << "file name" << parse_tree["file_name"] << endl;
+        cout << "Command: " << statement.command << endl;
+        cout << "table name: " << statement.table << endl;
+        cout << "columns " << statement.columns << endl;
+        cout << "fields " << statement.fields << endl;
+        cout << "values " << statement.values << endl;
+        cout << "where " << statement.where << endl;
+        cout << "file name" << statement.file_name << endl;
+        cout << "order by" << statement.order_by << endl;
+        cout << "limit" << statement.limit << endl;
+        cout << "group by" << statement.group_by << endl;
     }
 }
 
-// set each token to its proper key
-// E.G command = insert, select,
-void Parser::setMMap()
+// true if s is a row count: digits only
+static bool is_count(const string &s)
+{
+    if (s.empty() || s.size() > 9)
+        return false;
+    for (size_t i = 0; i < s.size(); ++i)
+        if (!isdigit(static_cast<unsigned char>(s[i])))
+            return false;
+    return true;
+}
+
+// between is only a keyword after a field of a where clause, order
+// only after the table or the where and so on. anywhere
+// else they are ordinary symbols, and so are they where the word after
+// them could not follow them (select count from t)
+int Parser::token_column(int row, size_t i)
+{
+    int column = keyword(commands[i]);
+    if (column < BETWEEN)
+        return column;
+    int to = table.cells[row][column];
+    if (to == -1)
+        return SYMBOL;
+    if (i + 1 < commands.size() && table.cells[row][SYMBOL] != -1 &&
+        table.cells[to][token_column(to, i + 1)] == -1)
+        return SYMBOL;
+    return column;
+}
+
+// the precedence of a logical operator: and binds tighter than or
+static int precedence(const string &op)
+{
+    return op == "and" ? 2 : 1;
+}
+
+// one step of the shunting yard: the logical operator between two
+// predicates goes after the ones before it that bind at least as tight
+static void push_logical(const string &op, vector<string> &pending,
+                         vector<string> &RPN)
+{
+    while (!pending.empty() && precedence(pending.back()) >= precedence(op))
+    {
+        RPN.push_back(pending.back());
+        pending.pop_back();
+    }
+    pending.push_back(op);
+}
+
+// set each token to its part of the statement
+// E.G insert is the command, the symbol after into is the table
+void Parser::setStatement()
 {
     bool debug = false;
     int nextRow = 0;
+    // the field and operator of the predicate being read, and the
+    // logical operators that are not in the where clause's RPN yet
+    string field;
+    string op;
+    vector<string> pending;
     // go through commands
     for (size_t i = 0; i < commands.size(); ++i)
     {
         if (debug)
             cout << commands[i] << "->";
-        nextRow = table[nextRow][keywords[commands[i]]];
-        if (nextRow != -1)
+        int column = token_column(nextRow, i);
+        nextRow = table.cells[nextRow][column];
+        if (nextRow == -1)
+            throw error("Invalid input!");
+
+        const string &word = commands[i];
+        if (column != SYMBOL)
         {
-            if (keywords.contains(commands[i]) && keywords[commands[i]] != SYMBOL)
-            {
-                // add commands to parse tree
-                switch (nextRow)
-                {
-                case 1:
-                    parse_tree["command"] += commands[i];
-                    break;
-                case 6:
-                    parse_tree["command"] += commands[i];
-                    break;
-                case 11:
-                    parse_tree["command"] += commands[i];
-                    break;
-                case 12:
-                    parse_tree["fields"] += commands[i];
-                    break;
-                case 17:
-                    parse_tree["relational"] += commands[i];
-                    break;
-                case 15:
-                    if (keywords[commands[i]] == LOGICAL)
-                    {
-                        parse_tree["logical"] += commands[i];
-                        break;
-                    }
-                    else
-                    {
-                        break;
-                    }
-                case 19:
-                    parse_tree["command"] += commands[i];
-                    break;
-                default:
-                    break;
-                }
-            }
-            else
+            switch (nextRow)
             {
-                switch (nextRow)
-                {
-                // values, fields and tablename to
-                case 3:
-                    parse_tree["table_name"] += commands[i];
-                    break;
-                case 5:
-                    parse_tree["fields"] += commands[i];
-                    break;
-                case 8:
-                    parse_tree["table_name"] += commands[i];
-                    break;
-                case 10:
-                    parse_tree["values"] += commands[i];
-                    break;
-                case 12:
-                    parse_tree["fields"] += commands[i];
-                    break;
-                case 14:
-                    parse_tree["table_name"] += commands[i];
-                    break;
-                case 16:
-                    parse_tree["fields"] += commands[i];
-                    break;
-                case 18:
-                    parse_tree["values"] += commands[i];
-                    break;
-                case 20:
-                    parse_tree["file_name"] += commands[i];
-                    break;
-                default:
-                    break;
-                }
+            case 1:
+                statement.command = CREATE_COMMAND;
+                break;
+            case 6:
+                statement.command = INSERT_COMMAND;
+                break;
+            case 11:
+                statement.command = SELECT_COMMAND;
+                break;
+            case 19:
+                statement.command = BATCH_COMMAND;
+                break;
+            case 21:
+                statement.command = BULK_COMMAND;
+                break;
+            case 50:
+                statement.command = ANALYZE_COMMAND;
+                break;
+            case 54:
+                statement.command = SET_COMMAND;
+                break;
+            case 56:
+                if (word != "=")
+                    throw error("Invalid Input: set needs a setting = value");
+                break;
+            // select *
+            case 12:
+                statement.columns.push_back(word);
+                break;
+            case 17:
+                op = word;
+                break;
+            case 15:
+                if (keyword(word) == LOGICAL)
+                    push_logical(word, pending, statement.where);
+                break;
+            // field between low and high is kept as
+            // field >= low and field <= high
+            case 28:
+                op = ">=";
+                break;
+            case 30:
+                if (word != "and")
+                    throw error("Invalid Input: between needs and");
+                push_logical(word, pending, statement.where);
+                op = "<=";
+                break;
+            // count(*): the parentheses are dropped by the
+            // tokenizer, the column is kept as written
+            case 39:
+                statement.columns.push_back(word + "(");
+                break;
+            case 43:
+                statement.columns.back() += word + ")";
+                break;
+            // explain [analyze] select ...
+            case 52:
+                statement.explain = true;
+                break;
+            case 53:
+                statement.analyze = true;
+                break;
+            case 48:
+                if (word != "=")
+                    throw error("Invalid Input: join needs on a.x = b.y");
+                break;
+            // asc or desc
+            case 34:
+                statement.descending = word == "desc";
+                break;
+            default:
+                break;
             }
         }
         else
         {
-            throw error("Invalid input!");
+            switch (nextRow)
+            {
+            // values, fields and tablename to
+            case 3:
+            case 8:
+            case 14:
+            case 24:
+            case 51:
+                statement.table = word;
+                break;
+            case 5:
+            {
+                // fields are strings unless a type follows them, as in
+                // salary:int
+                size_t colon = word.find(':');
+                statement.fields.push_back(word.substr(0, colon));
+                statement.types.push_back(colon == string::npos
+                                              ? "string"
+                                              : word.substr(colon + 1));
+                break;
+            }
+            case 10:
+                statement.values.push_back(word);
+                break;
+            case 12:
+                statement.columns.push_back(word);
+                break;
+            case 16:
+                field = word;
+                break;
+            // the value ends a predicate, it goes to the RPN whole
+            case 18:
+            case 29:
+                statement.where.push_back(field);
+                statement.where.push_back(word);
+                statement.where.push_back(op);
+                break;
+            case 20:
+            case 26:
+                statement.file_name = word;
+                break;
+            // the words of the setting, then its value
+            case 55:
+                if (!statement.setting.empty())
+                    statement.setting += ' ';
+                statement.setting += word;
+                break;
+            case 57:
+                statement.setting_value = word;
+                break;
+            case 33:
+                statement.order_by = word;
+                break;
+            case 42:
+                statement.group_by = word;
+                break;
+            case 45:
+                statement.join = word;
+                break;
+            case 47:
+            case 49:
+                statement.on.push_back(word);
+                break;
+            case 43:
+                statement.columns.back() += word + ")";
+                break;
+            case 36:
+                if (!is_count(word))
+                    throw error("Invalid Input: limit needs a number");
+                statement.limit = atol(word.c_str());
+                break;
+            case 38:
+                if (!is_count(word))
+                    throw error("Invalid Input: offset needs a number");
+                statement.offset = atol(word.c_str());
+                break;
+            default:
+                break;
+            }
         }
     }
     // we must end in a success state
@@ -232,107 +390,231 @@ void Parser::setMMap()
     {
         throw error("Invalid Input: Check Syntax");
     }
+
+    // the logical operators left go last, the loosest at the end
+    for (size_t i = pending.size(); i > 0; --i)
+        statement.where.push_back(pending[i - 1]);
+    if (!statement.where.empty())
+        statement.where = fuseRanges(statement.where);
+}
+
+// one node of a where clause while its ranges are fused: a predicate
+// (field op value, or field low high bounds for a range) or an and/or
+// of two nodes
+struct Condition
+{
+    string op;
+    vector<string> operands;
+    vector<Condition> children;
+};
+
+static bool is_range(const string &op)
+{
+    return op == "[]" || op == "[)" || op == "(]" || op == "()";
+}
+
+static bool is_lower(const string &op) { return op == ">" || op == ">="; }
+static bool is_upper(const string &op) { return op == "<" || op == "<="; }
+
+// adds the conjuncts of an and (looking through nested ands) to list
+static void conjuncts(Condition &c, vector<Condition> &list)
+{
+    if (c.op != "and")
+    {
+        list.push_back(std::move(c));
+        return;
+    }
+    conjuncts(c.children[0], list);
+    conjuncts(c.children[1], list);
 }
 
-// turns infix to postfix
-vector<string> Parser::shuntingYard()
+// fuses the ranges of c and everything under it
+static void fuse(Condition &c)
 {
-    // shunting yard on ptree
-    MMap<string, string> temp;
+    if (c.op != "and" && c.op != "or")
+        return;
+    if (c.op == "or")
+    {
+        fuse(c.children[0]);
+        fuse(c.children[1]);
+        return;
+    }
 
-    vector<string> opstack;
-    map<string, int> op;
-    loadPrecedence(op);
-    vector<string> RPN;
+    vector<Condition> list;
+    conjuncts(c, list);
+    for (size_t i = 0; i < list.size(); ++i)
+        fuse(list[i]);
 
-    // get all strings in the order that they came in
-    // store in expressions
-    for (size_t i = 0; i < parse_tree["values"].size(); ++i)
+    // pair the first lower bound of a field with its first upper
+    // bound. the range takes the place of whichever came first
+    for (size_t i = 0; i < list.size(); ++i)
     {
-        // kept value fields and relation in the same order
-        // or order for logical will change
-        RPN += parse_tree["fields"][i + 1];
-        RPN += parse_tree["values"][i];
-        RPN += parse_tree["relational"][i];
-
-        // if there is a logical expression take it in
-        if (i < parse_tree["logical"].size())
+        if (!is_lower(list[i].op) && !is_upper(list[i].op))
+            continue;
+        for (size_t j = i + 1; j < list.size(); ++j)
         {
-            // check precedence
-            while (!opstack.empty() && op.at(opstack.back()) >= op.at(parse_tree["logical"][i]))
-            {
-                RPN += opstack.back();
-                opstack.pop_back();
-            }
-            opstack.push_back(parse_tree["logical"][i]);
+            if (list[j].operands[0] != list[i].operands[0] ||
+                is_lower(list[j].op) == is_lower(list[i].op) ||
+                (!is_lower(list[j].op) && !is_upper(list[j].op)))
+                continue;
+            const Condition &low = is_lower(list[i].op) ? list[i] : list[j];
+            const Condition &high = is_lower(list[i].op) ? list[j] : list[i];
+            Condition range;
+            range.op = string(low.op == ">=" ? "[" : "(") +
+                       (high.op == "<=" ? "]" : ")");
+            range.operands = {low.operands[0], low.operands[1],
+                              high.operands[1]};
+            list[i] = std::move(range);
+            list.erase(list.begin() + j);
+            break;
         }
     }
 
-    for (size_t i = opstack.size(); i > 0; --i)
+    // and the conjuncts back together, left to right
+    Condition result = std::move(list[0]);
+    for (size_t i = 1; i < list.size(); ++i)
     {
-        RPN += opstack[i - 1];
-        opstack.pop_back();
+        Condition both;
+        both.op = "and";
+        both.children.push_back(std::move(result));
+        both.children.push_back(std::move(list[i]));
+        result = std::move(both);
     }
-
-    return RPN;
+    c = std::move(result);
 }
 
-// load the precedence between and or or
-void Parser::loadPrecedence(map<string, int> &operators)
+// writes c back out in RPN
+static void emit(const Condition &c, vector<string> &RPN)
 {
-    operators["and"] = 2;
-    operators["or"] = 1;
+    for (size_t i = 0; i < c.children.size(); ++i)
+        emit(c.children[i], RPN);
+    for (size_t i = 0; i < c.operands.size(); ++i)
+        RPN.push_back(c.operands[i]);
+    RPN.push_back(c.op);
 }
 
-void Parser::initKeys()
+// builds the where clause from RPN, fuses its ranges and turns it back
+// into RPN
+vector<string> Parser::fuseRanges(const vector<string> &RPN)
 {
-    keywords["make"] = CREATE;
-    keywords["create"] = CREATE;
-    keywords["insert"] = INSERT;
-    keywords["into"] = INTO;
-    keywords["values"] = VALUES;
-    keywords["table"] = TABLE;
-    keywords["fields"] = FIELDS;
-    keywords["select"] = SELECT;
-    keywords["batch"] = BATCH;
-
-    keywords["*"] = STAR;
-    keywords["from"] = FROM;
-    keywords["where"] = WHERE;
-    keywords[">"] = RELATIONAL;
-    keywords["="] = RELATIONAL;
-    keywords["<"] = RELATIONAL;
-    keywords["<="] = RELATIONAL;
-    keywords[">="] = RELATIONAL;
-    keywords["and"] = LOGICAL;
-    keywords["or"] = LOGICAL;
-
-    // set any unknown values to symbol
-    // this can be a value, field, or tablename depending on what is
-    // before it
-    for (size_t i = 0; i < commands.size(); i++)
+    vector<Condition> stack;
+    vector<string> operands;
+    for (size_t i = 0; i < RPN.size(); ++i)
     {
-        if (!keywords.contains(commands[i]))
+        const string &token = RPN[i];
+        Condition c;
+        c.op = token;
+        if (token == "and" || token == "or")
+        {
+            if (stack.size() < 2)
+                return RPN;
+            c.children.push_back(std::move(stack[stack.size() - 2]));
+            c.children.push_back(std::move(stack.back()));
+            stack.pop_back();
+            stack.pop_back();
+        }
+        else if (token == "=" || is_lower(token) || is_upper(token) ||
+                 is_range(token))
         {
-            keywords[commands[i]] = SYMBOL;
+            size_t n = is_range(token) ? 3 : 2;
+            if (operands.size() < n)
+                return RPN;
+            c.operands.assign(operands.end() - n, operands.end());
+            operands.resize(operands.size() - n);
         }
+        else
+        {
+            operands.push_back(token);
+            continue;
+        }
+        stack.push_back(std::move(c));
     }
+    // not a where clause we understand, leave it alone
+    if (stack.size() != 1 || !operands.empty())
+        return RPN;
+
+    fuse(stack[0]);
+    vector<string> fused;
+    emit(stack[0], fused);
+    return fused;
 }
-// initialize table
-void Parser::initTable()
+
+// every keyword of the grammar. the seed of the hash is the first one
+// that puts no two of them in the same slot, anything not found is a
+// symbol: a value, field, or tablename depending on what is before it
+constexpr KeywordTable Parser::makeKeywords()
 {
-    for (int i = 0; i < PROWS; ++i)
+    const Keyword words[] = {
+        {"make", CREATE},
+        {"create", CREATE},
+        {"insert", INSERT},
+        {"into", INTO},
+        {"values", VALUES},
+        {"table", TABLE},
+        {"fields", FIELDS},
+        {"select", SELECT},
+        {"batch", BATCH},
+        {"bulk", BULK},
+
+        {"*", STAR},
+        {"from", FROM},
+        {"where", WHERE},
+        {">", RELATIONAL},
+        {"=", RELATIONAL},
+        {"<", RELATIONAL},
+        {"<=", RELATIONAL},
+        {">=", RELATIONAL},
+        {"and", LOGICAL},
+        {"or", LOGICAL},
+        {"between", BETWEEN},
+        {"order", ORDER},
+        {"by", BY},
+        {"asc", DIRECTION},
+        {"desc", DIRECTION},
+        {"limit", LIMIT},
+        {"offset", OFFSET},
+        {"count", AGGREGATE},
+        {"sum", AGGREGATE},
+        {"avg", AGGREGATE},
+        {"min", AGGREGATE},
+        {"max", AGGREGATE},
+        {"group", GROUP},
+        {"join", JOIN},
+        {"on", ON},
+        {"analyze", ANALYZE},
+        {"explain", EXPLAIN},
+        {"set", SET},
+    };
+    const int count = sizeof(words) / sizeof(words[0]);
+
+    KeywordTable keys;
+    for (uint32_t seed = 1; seed < 100000; ++seed)
     {
-        for (int j = 0; j < PCOLS; ++j)
+        keys = KeywordTable();
+        bool collided = false;
+        for (int i = 0; i < count && !collided; ++i)
         {
-            if (j == 0)
-            {
-                table[i][j] = 0;
-            }
-            else
-                table[i][j] = -1;
+            Keyword &slot = keys.slots[KeywordTable::slot_of(words[i].word,
+                                                             seed)];
+            collided = !slot.word.empty();
+            slot = words[i];
+        }
+        if (!collided)
+        {
+            keys.seed = seed;
+            return keys;
         }
     }
+    return KeywordTable();
+}
+
+constexpr KeywordTable Parser::keywords = Parser::makeKeywords();
+
+int Parser::keyword(string_view word)
+{
+    static_assert(keywords.seed != 0, "no perfect hash for the keywords");
+    int column = keywords.find(word);
+    return column < 0 ? SYMBOL : column;
 }
 
 // Precondition: _table is our adjacency matric,
@@ -345,112 +627,192 @@ void Parser::printTable(int row_from, int row_to, int col_from, int col_to)
     {
         // prints out rows and their contents
         for (int j = col_from; j <= col_to && j < PCOLS; ++j)
-            cout << "|" << table[i][j] << "|";
+            cout << "|" << table.cells[i][j] << "|";
         cout << endl;
     }
 }
 
-// Precondition: _table is our adjacency matrix, state is a row in the table
-// Postcondition: Mark this state (row) with a 1 (success)
-void Parser::mark_success(int state)
-{
-    table[state][0] = 1;
-}
-
-// Precondition: _table is our adjacency matrix, state is a row in the table
-// Postcondition: Mark this state (row) with a 0 (not success)
-void Parser::mark_fail(int state)
-{
-    table[state][0] = 0;
-}
-
-// Precondition: Similar to function above except
-// Mark columns represented by the string columns[] for this row
-// We will be given "west" and we make every column that corresponds with
-// the ascii value of each char as the state desired
-// Postcondition: marks a range of cells in this array
-void Parser::mark_cell(int row, int column, int state)
-{
-    for (int i = 0; i < PROWS; ++i)
-    {
-        for (int j = 0; j < PCOLS; ++j)
-        {
-            if (i == row && j == column)
-            {
-                table[i][j] = state;
-            }
-        }
-    }
-}
-
 // Precondition: _table is our adjacency matrix, state is a row in the table
 // Postcondition: returns true if state is a success state
 bool Parser::is_success(int state)
 {
-    if (table[state][0] == 1)
+    if (table.cells[state][0] == 1)
         return true;
     else
         return false;
 }
 
 // This state machine should represent the grammar for command line
-// interpretation
-void Parser::makeTable()
+// interpretation. it is run by the compiler, the table is a constant
+constexpr ParseTable Parser::makeTable()
 {
-    // initialize our table to all negative 1
-    initTable();
+    // every cell starts out as -1
+    ParseTable table;
 
     // MAKE/CREATE MACHINE
-    mark_fail(0);
-    mark_fail(1);
-    mark_fail(2);
-    mark_fail(3);
-    mark_fail(4);
-    mark_success(5);
-    mark_cell(0, CREATE, 1);
-    mark_cell(1, TABLE, 2);
-    mark_cell(2, SYMBOL, 3);
-    mark_cell(3, FIELDS, 4);
-    mark_cell(4, SYMBOL, 5);
-    mark_cell(5, SYMBOL, 5);
+    table.mark_fail(0);
+    table.mark_fail(1);
+    table.mark_fail(2);
+    table.mark_fail(3);
+    table.mark_fail(4);
+    table.mark_success(5);
+    table.mark_cell(0, CREATE, 1);
+    table.mark_cell(1, TABLE, 2);
+    table.mark_cell(2, SYMBOL, 3);
+    table.mark_cell(3, FIELDS, 4);
+    table.mark_cell(4, SYMBOL, 5);
+    table.mark_cell(5, SYMBOL, 5);
 
     // INSERT MACHINE
-    mark_fail(6);
-    mark_fail(7);
-    mark_fail(8);
-    mark_fail(9);
-    mark_success(10);
-    mark_cell(0, INSERT, 6);
-    mark_cell(6, INTO, 7);
-    mark_cell(7, SYMBOL, 8);
-    mark_cell(8, VALUES, 9);
-    mark_cell(9, SYMBOL, 10);
-    mark_cell(10, SYMBOL, 10);
+    table.mark_fail(6);
+    table.mark_fail(7);
+    table.mark_fail(8);
+    table.mark_fail(9);
+    table.mark_success(10);
+    table.mark_cell(0, INSERT, 6);
+    table.mark_cell(6, INTO, 7);
+    table.mark_cell(7, SYMBOL, 8);
+    table.mark_cell(8, VALUES, 9);
+    table.mark_cell(9, SYMBOL, 10);
+    table.mark_cell(10, SYMBOL, 10);
 
     // SELECT MACHINE
-    mark_fail(11);
-    mark_fail(12);
-    mark_fail(13);
-    mark_success(14);
-    mark_fail(15);
-    mark_fail(16);
-    mark_fail(17);
-    mark_success(18);
-
-    mark_cell(0, SELECT, 11);
-    mark_cell(11, STAR, 12);
-    mark_cell(11, SYMBOL, 12);
-    mark_cell(12, FROM, 13);
-    mark_cell(13, SYMBOL, 14);
-    mark_cell(14, WHERE, 15);
-    mark_cell(15, SYMBOL, 16);
-    mark_cell(16, RELATIONAL, 17);
-    mark_cell(17, SYMBOL, 18);
-    mark_cell(18, LOGICAL, 15);
+    table.mark_fail(11);
+    table.mark_fail(12);
+    table.mark_fail(13);
+    table.mark_success(14);
+    table.mark_fail(15);
+    table.mark_fail(16);
+    table.mark_fail(17);
+    table.mark_success(18);
+
+    table.mark_cell(0, SELECT, 11);
+    table.mark_cell(11, STAR, 12);
+    table.mark_cell(11, SYMBOL, 12);
+    // select lname, age from student
+    table.mark_cell(12, SYMBOL, 12);
+    table.mark_cell(12, FROM, 13);
+    table.mark_cell(13, SYMBOL, 14);
+    table.mark_cell(14, WHERE, 15);
+    table.mark_cell(15, SYMBOL, 16);
+    table.mark_cell(16, RELATIONAL, 17);
+    table.mark_cell(17, SYMBOL, 18);
+    table.mark_cell(18, LOGICAL, 15);
+    // where age between 20 and 30
+    table.mark_fail(28);
+    table.mark_fail(29);
+    table.mark_fail(30);
+    table.mark_cell(16, BETWEEN, 28);
+    table.mark_cell(28, SYMBOL, 29);
+    table.mark_cell(29, LOGICAL, 30);
+    table.mark_cell(30, SYMBOL, 18);
+    // select lname, count(*), max(age) from student
+    table.mark_fail(39);
+    table.mark_fail(43);
+    table.mark_cell(11, AGGREGATE, 39);
+    table.mark_cell(12, AGGREGATE, 39);
+    table.mark_cell(39, STAR, 43);
+    table.mark_cell(39, SYMBOL, 43);
+    table.mark_cell(43, SYMBOL, 12);
+    table.mark_cell(43, AGGREGATE, 39);
+    table.mark_cell(43, FROM, 13);
+    // ... group by lname, after the table or the where
+    table.mark_fail(40);
+    table.mark_fail(41);
+    table.mark_success(42);
+    table.mark_cell(14, GROUP, 40);
+    table.mark_cell(18, GROUP, 40);
+    table.mark_cell(40, BY, 41);
+    table.mark_cell(41, SYMBOL, 42);
+    table.mark_cell(42, ORDER, 31);
+    // ... from emp join dept on emp.dept = dept.name, before the where
+    table.mark_fail(44);
+    table.mark_fail(45);
+    table.mark_fail(46);
+    table.mark_fail(47);
+    table.mark_fail(48);
+    table.mark_success(49);
+    table.mark_cell(14, JOIN, 44);
+    table.mark_cell(44, SYMBOL, 45);
+    table.mark_cell(45, ON, 46);
+    table.mark_cell(46, SYMBOL, 47);
+    table.mark_cell(47, RELATIONAL, 48);
+    table.mark_cell(48, SYMBOL, 49);
+    table.mark_cell(49, WHERE, 15);
+    // ... order by lname [asc|desc], after the table or the where
+    table.mark_fail(31);
+    table.mark_fail(32);
+    table.mark_success(33);
+    table.mark_success(34);
+    table.mark_cell(14, ORDER, 31);
+    table.mark_cell(18, ORDER, 31);
+    table.mark_cell(31, BY, 32);
+    table.mark_cell(32, SYMBOL, 33);
+    table.mark_cell(33, DIRECTION, 34);
+    // ... limit 10 offset 20, at the very end. either can be left out
+    table.mark_fail(35);
+    table.mark_success(36);
+    table.mark_fail(37);
+    table.mark_success(38);
+    for (int state : {14, 18, 33, 34, 42, 49})
+    {
+        table.mark_cell(state, LIMIT, 35);
+        table.mark_cell(state, OFFSET, 37);
+    }
+    table.mark_cell(35, SYMBOL, 36);
+    table.mark_cell(36, OFFSET, 37);
+    table.mark_cell(37, SYMBOL, 38);
+
+    // ANALYZE MACHINE
+    // analyze student
+    table.mark_fail(50);
+    table.mark_success(51);
+    table.mark_cell(0, ANALYZE, 50);
+    table.mark_cell(50, SYMBOL, 51);
+
+    // EXPLAIN MACHINE
+    // explain [analyze] select ..., the rest is the select machine
+    table.mark_fail(52);
+    table.mark_fail(53);
+    table.mark_cell(0, EXPLAIN, 52);
+    table.mark_cell(52, ANALYZE, 53);
+    table.mark_cell(52, SELECT, 11);
+    table.mark_cell(53, SELECT, 11);
+
+    // SET MACHINE
+    // set sort budget = 1048576
+    table.mark_fail(54);
+    table.mark_fail(55);
+    table.mark_fail(56);
+    table.mark_success(57);
+    table.mark_cell(0, SET, 54);
+    table.mark_cell(54, SYMBOL, 55);
+    table.mark_cell(55, SYMBOL, 55);
+    table.mark_cell(55, RELATIONAL, 56);
+    table.mark_cell(56, SYMBOL, 57);
 
     // Batch Machine
-    mark_fail(19);
-    mark_success(20);
-    mark_cell(0, BATCH, 19);
-    mark_cell(19, SYMBOL, 20);
+    table.mark_fail(19);
+    table.mark_success(20);
+    table.mark_cell(0, BATCH, 19);
+    table.mark_cell(19, SYMBOL, 20);
+
+    // BULK INSERT MACHINE
+    // bulk insert into employee from "employees.csv"
+    table.mark_fail(21);
+    table.mark_fail(22);
+    table.mark_fail(23);
+    table.mark_fail(24);
+    table.mark_fail(25);
+    table.mark_success(26);
+    table.mark_cell(0, BULK, 21);
+    table.mark_cell(21, INSERT, 22);
+    table.mark_cell(22, INTO, 23);
+    table.mark_cell(23, SYMBOL, 24);
+    table.mark_cell(24, FROM, 25);
+    table.mark_cell(25, SYMBOL, 26);
+
+    return table;
 }
+
+constexpr ParseTable Parser::table = Parser::makeTable();
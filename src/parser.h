@@ -2,14 +2,89 @@
 #define PARSER_H
 
 #include "stokenizer.h"
-#include "map.h"
-#include "mmap.h"
+#include "statement.h"
+#include <cstdint>
+#include <string_view>
 
 using namespace std;
 
-const int PROWS = 30;
+const int PROWS = 60;
 const int PCOLS = 30;
 
+/*
+ * The state table of the parser's grammar. cells[state][column] is the
+ * state a token of that column leads to, -1 if it cannot follow. Column
+ * 0 of a state is 1 if the state is a success state, 0 if not.
+ *
+ * Everything here is constexpr so the table of Parser is worked out by
+ * the compiler (see Parser::makeTable) and a Parser builds nothing.
+ */
+struct ParseTable
+{
+    //Post: every state fails and leads nowhere
+    constexpr ParseTable(): cells()
+    {
+        for (int i = 0; i < PROWS; ++i)
+            for (int j = 1; j < PCOLS; ++j)
+                cells[i][j] = -1;
+    }
+
+    //mark row for sucess
+    constexpr void mark_success(int state) {cells[state][0] = 1;}
+    //mmark row for failure
+    constexpr void mark_fail(int state) {cells[state][0] = 0;}
+    //mark specific cell
+    constexpr void mark_cell(int row, int column, int state)
+    {
+        cells[row][column] = state;
+    }
+
+    int cells[PROWS][PCOLS];
+};
+
+//a keyword and the column of the parse table it is read as
+struct Keyword
+{
+    string_view word;
+    int column = -1;
+};
+
+//slots of the keyword table, a power of two
+const int KEYWORD_SLOTS = 256;
+
+/*
+ * The keywords of the grammar in a perfect hash table: seed is picked
+ * at compile time so that no two keywords hash to the same slot, and a
+ * lookup is one hash and one compare.
+ */
+struct KeywordTable
+{
+    constexpr KeywordTable(): seed(0), slots() {}
+
+    //the slot of word when hashed with seed (FNV-1a)
+    static constexpr size_t slot_of(string_view word, uint32_t seed)
+    {
+        uint32_t h = 2166136261u ^ seed;
+        for (size_t i = 0; i < word.size(); ++i)
+        {
+            h ^= static_cast<unsigned char>(word[i]);
+            h *= 16777619u;
+        }
+        return (h ^ (h >> 16)) & (KEYWORD_SLOTS - 1);
+    }
+
+    //the column of word, -1 if it is not a keyword
+    constexpr int find(string_view word) const
+    {
+        const Keyword& k = slots[slot_of(word, seed)];
+        return !word.empty() && k.word == word ? k.column : -1;
+    }
+
+    //0 until a seed without collisions has been found
+    uint32_t seed;
+    Keyword slots[KEYWORD_SLOTS];
+};
+
 class Parser
 {
 public:
@@ -18,65 +93,71 @@ public:
  *                      C T O R
  * *************************************************************
 */
-    //CTOR-> Take in string, create adjacency table
+    //CTOR-> Take in string and parse it. the table and the keywords
+    //are made at compile time, constructing a parser builds neither.
+    //phrase is only read while the parser is constructed
     Parser();
-    Parser(char* phrase);
+    Parser(string_view phrase);
 /*
  * *************************************************************
  *             T A B L E   F U N C T I O N S
  * *************************************************************
 */
-    //Post: Create table
-    void makeTable();
-    //Post: Initialize tble
-    void initTable();
     //Post: Prints table
     void printTable(int row_from = 0, int row_to = PROWS,
                     int col_from = 0, int col_to = PCOLS);
-    //mark row for sucess
-    void mark_success(int state);
-    //mmark row for failure
-    void mark_fail(int state);
-    //mark specific cell
-    void mark_cell(int row, int col, int state);
     bool is_success(int state);
 /*
  * *************************************************************
  *              S H U N T I N G     Y A R D
  * *************************************************************
 */
-    //shunting yard on parse_tree entries, and returns RPN as vector
-    vector<string> shuntingYard();
-    void loadPrecedence(map<string, int> &operators);
+    //rewrites RPN so the lower and upper bound of a field that are
+    //and'ed together become one range predicate:
+    //  age 20 > age 30 < and  ->  age 20 30 ()
+    //the last token tells which ends are included: [] [) (] or ()
+    static vector<string> fuseRanges(const vector<string>& RPN);
 
 /*
  * *************************************************************
  *          P A R S E   T R E E   F U N C T I O N S
  * *************************************************************
 */
-    //sets user input to appropriate keys in mmap
-    void setMMap();
-    MMap<string, string> get_parse_tree(){return parse_tree;}
+    //sets each token to its part of the statement, and turns the
+    //where clause into RPN as its predicates are read
+    void setStatement();
+    //the statement parsed. it can be moved out of the parser
+    Statement& get_statement(){return statement;}
 
 /*
  * *************************************************************
  *               E X T R A   F U N C T I O N S
  * *************************************************************
 */
-    //Post: Initialize Keyswords
-    void initKeys();
     void set_string(char command[]);
 private:
+    //the column of commands[i] read in state row
+    int token_column(int row, size_t i);
+
+    //the column of word, SYMBOL if it is not a keyword
+    static int keyword(string_view word);
+
+    //Post: the grammar's state table
+    static constexpr ParseTable makeTable();
+    //Post: the keywords and their columns, hashed
+    static constexpr KeywordTable makeKeywords();
 
 /*
  * *************************************************************
  *            P R I V A T E     V A R I A B L E S
  * *************************************************************
 */
-    //enum of indeces
+    //enum of indeces. the ones from BETWEEN on are only keywords where
+    //the grammar expects them, anywhere else they are symbols
     enum indeces {ZERO, CREATE, TABLE, SYMBOL, FIELDS,
                   INSERT, INTO, VALUES, SELECT, STAR, FROM, WHERE, RELATIONAL, LOGICAL
-                 , BATCH};
+                 , BATCH, BULK, BETWEEN, ORDER, BY, DIRECTION, LIMIT
+                 , OFFSET, AGGREGATE, GROUP, JOIN, ON, ANALYZE, EXPLAIN, SET};
     //our stokenizer
     STokenizer stk;
 
@@ -84,14 +165,14 @@ private:
     vector<string> commands;
 
     //our keywords and their indexed values
-    Map<string, indeces> keywords;
+    static const KeywordTable keywords;
 
     //our parse tree, will hold all tokens in their correct place
     //extracted from user input
-    MMap<string, string> parse_tree;
+    Statement statement;
 
     //our table
-    int table[PROWS][PCOLS];
+    static const ParseTable table;
 
 };
 
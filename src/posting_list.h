@@ -0,0 +1,229 @@
+#ifndef POSTING_LIST_H
+#define POSTING_LIST_H
+
+#include "mylib.h"
+
+using namespace std;
+
+/*
+ * A PostingList holds the record numbers of one index key, in
+ * ascending order, compressed. Each record number is stored as its
+ * distance from the one before it, written as a varint: 7 bits per
+ * byte, the high bit set on every byte but the last. The record
+ * numbers of a key are usually close together, so most of them take
+ * one byte instead of the four of a vector<int>.
+ *
+ * push_back() of a record number no smaller than the last one (which
+ * is what insert does) appends to the end. A smaller one makes the
+ * list decode, insert it and encode again.
+ */
+class PostingList
+{
+public:
+/*
+ * *************************************************************
+ *          N E S T E D     I T E R A T O R     C L A S S
+ * *************************************************************
+*/
+    //decodes the record numbers one at a time, front to back
+    class Iterator
+    {
+    public:
+        Iterator(const unsigned char* _pos = NULL,
+                 const unsigned char* _end = NULL)
+            : pos(_pos), end(_end), value(0)
+        {
+            if (pos != end)
+                value = decode();
+        }
+
+        //overloaded dereference operator
+        int operator *() const {return value;}
+
+        //overloaded incrementation operator
+        Iterator& operator++()
+        {
+            if (pos != end)
+                value += decode();
+            else
+                pos = NULL;
+            return *this;
+        }
+
+        //overloaded incrementation operator
+        Iterator operator++(int un_used)
+        {
+            (void)un_used;
+            Iterator temp = *this;
+            ++*this;
+            return temp;
+        }
+
+        friend bool operator ==(const Iterator& lhs, const Iterator& rhs)
+        {
+            return lhs.pos == rhs.pos;
+        }
+        friend bool operator !=(const Iterator& lhs, const Iterator& rhs)
+        {
+            return lhs.pos != rhs.pos;
+        }
+
+    private:
+        //reads one varint and moves pos past it. stepping past the
+        //last one sets pos to NULL, which is the end iterator
+        int decode()
+        {
+            unsigned int delta = 0;
+            int shift = 0;
+            while (*pos & 0x80)
+            {
+                delta |= static_cast<unsigned int>(*pos++ & 0x7f) << shift;
+                shift += 7;
+            }
+            delta |= static_cast<unsigned int>(*pos++) << shift;
+            return static_cast<int>(delta);
+        }
+
+        const unsigned char* pos;
+        const unsigned char* end;
+        int value;
+    };
+
+/*
+ * *************************************************************
+ *                       C T O R S
+ * *************************************************************
+*/
+    PostingList(): count(0), last(0) {}
+
+    //a list of the record numbers in recnos
+    PostingList(const vector<int>& recnos): count(0), last(0)
+    {
+        assign(recnos);
+    }
+
+/*
+ * *************************************************************
+ *                    A C C E S S O R S
+ * *************************************************************
+*/
+    //number of record numbers
+    int size() const {return count;}
+    bool empty() const {return count == 0;}
+    //bytes the encoded record numbers take
+    size_t byte_size() const {return bytes.size();}
+
+    //the first record number, the list must not be empty
+    int front() const
+    {
+        assert(count > 0);
+        return *begin();
+    }
+
+    //the record numbers, decoded
+    vector<int> to_vector() const
+    {
+        vector<int> recnos;
+        recnos.reserve(count);
+        for (Iterator it = begin(); it != end(); ++it)
+            recnos.push_back(*it);
+        return recnos;
+    }
+
+    Iterator begin() const
+    {
+        if (bytes.empty())
+            return end();
+        return Iterator(bytes.data(), bytes.data() + bytes.size());
+    }
+    Iterator end() const {return Iterator();}
+
+/*
+ * *************************************************************
+ *                    M O D I F I E R S
+ * *************************************************************
+*/
+    //adds recno to the list, keeping it sorted
+    void push_back(int recno)
+    {
+        if (count == 0 || recno >= last)
+        {
+            encode(static_cast<unsigned int>(recno - last));
+            last = recno;
+            ++count;
+            return;
+        }
+        // out of order: put it in its place and encode it all again
+        vector<int> recnos = to_vector();
+        recnos.insert(upper_bound(recnos.begin(), recnos.end(), recno),
+                      recno);
+        assign(recnos);
+    }
+
+    //same as push_back, used as index[key] += recno
+    PostingList& operator +=(int recno)
+    {
+        push_back(recno);
+        return *this;
+    }
+
+    //replaces the list with the record numbers in recnos
+    void assign(const vector<int>& recnos)
+    {
+        clear();
+        bytes.reserve(recnos.size());
+        if (is_sorted(recnos.begin(), recnos.end()))
+        {
+            for (size_t i = 0; i < recnos.size(); ++i)
+                push_back(recnos[i]);
+            return;
+        }
+        vector<int> sorted(recnos);
+        sort(sorted.begin(), sorted.end());
+        for (size_t i = 0; i < sorted.size(); ++i)
+            push_back(sorted[i]);
+    }
+
+    void clear()
+    {
+        bytes.clear();
+        count = 0;
+        last = 0;
+    }
+
+    //gives back the spare capacity of the encoded bytes
+    void shrink_to_fit() {bytes.shrink_to_fit();}
+
+/*
+ * *************************************************************
+ *                       O U T P U T
+ * *************************************************************
+*/
+    friend ostream& operator <<(ostream& outs, const PostingList& print_me)
+    {
+        for (Iterator it = print_me.begin(); it != print_me.end(); ++it)
+            outs << *it << " ";
+        return outs;
+    }
+
+private:
+    //appends delta as a varint
+    void encode(unsigned int delta)
+    {
+        while (delta >= 0x80)
+        {
+            bytes.push_back(static_cast<unsigned char>(delta | 0x80));
+            delta >>= 7;
+        }
+        bytes.push_back(static_cast<unsigned char>(delta));
+    }
+
+    //the varint encoded distances between record numbers
+    vector<unsigned char> bytes;
+    //how many record numbers are in the list
+    int count;
+    //the last (largest) record number, where the next delta starts
+    int last;
+};
+
+#endif // POSTING_LIST_H
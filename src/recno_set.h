@@ -0,0 +1,133 @@
+#ifndef RECNO_SET_H
+#define RECNO_SET_H
+
+#include "mylib.h"
+#include <cstdint>
+
+using namespace std;
+
+/*
+ * A RecnoSet is a set of record numbers kept as a bitmap, one bit per
+ * record of the table. The and/or of a where clause combine two sets
+ * a 64 bit word at a time, so a chain of predicates costs one pass
+ * over the words each instead of sorting record number lists.
+ *
+ * The word loops are plain loops over uint64_t so the compiler can
+ * vectorize them for whatever target it builds for.
+ */
+class RecnoSet
+{
+public:
+/*
+ * *************************************************************
+ *                       C T O R S
+ * *************************************************************
+*/
+    //an empty set for a table of count records
+    RecnoSet(int count = 0): words(word_count(count), 0) {}
+
+    //the set of recnos, for a table of count records
+    RecnoSet(const vector<int>& recnos, int count)
+        : words(word_count(count), 0)
+    {
+        for (size_t i = 0; i < recnos.size(); ++i)
+            insert(recnos[i]);
+    }
+
+/*
+ * *************************************************************
+ *              S E A R C H I N G  &  A C C E S S
+ * *************************************************************
+*/
+    bool contains(int recno) const
+    {
+        size_t w = static_cast<size_t>(recno) / 64;
+        return recno >= 0 && w < words.size() &&
+               (words[w] >> (recno % 64) & 1);
+    }
+
+    //number of record numbers in the set
+    int size() const
+    {
+        int n = 0;
+        for (size_t i = 0; i < words.size(); ++i)
+            n += popcount(words[i]);
+        return n;
+    }
+
+    //the record numbers in the set, smallest first
+    vector<int> to_vector() const
+    {
+        vector<int> recnos;
+        recnos.reserve(size());
+        for (size_t i = 0; i < words.size(); ++i)
+        {
+            uint64_t word = words[i];
+            while (word)
+            {
+                recnos.push_back(static_cast<int>(i * 64) +
+                                 lowest_bit(word));
+                word &= word - 1;
+            }
+        }
+        return recnos;
+    }
+
+/*
+ * *************************************************************
+ *              M O D I F I E R     F U N C T I O N S
+ * *************************************************************
+*/
+    //adds recno to the set. negative record numbers are ignored
+    void insert(int recno)
+    {
+        if (recno < 0)
+            return;
+        size_t w = static_cast<size_t>(recno) / 64;
+        if (w >= words.size())
+            words.resize(w + 1, 0);
+        words[w] |= uint64_t(1) << (recno % 64);
+    }
+
+    //keeps the record numbers that are also in other
+    RecnoSet& operator &=(const RecnoSet& other)
+    {
+        size_t n = min(words.size(), other.words.size());
+        for (size_t i = 0; i < n; ++i)
+            words[i] &= other.words[i];
+        for (size_t i = n; i < words.size(); ++i)
+            words[i] = 0;
+        return *this;
+    }
+
+    //adds the record numbers of other
+    RecnoSet& operator |=(const RecnoSet& other)
+    {
+        if (words.size() < other.words.size())
+            words.resize(other.words.size(), 0);
+        for (size_t i = 0; i < other.words.size(); ++i)
+            words[i] |= other.words[i];
+        return *this;
+    }
+
+private:
+    static size_t word_count(int count)
+    {
+        return count > 0 ? (static_cast<size_t>(count) + 63) / 64 : 0;
+    }
+
+    static int popcount(uint64_t word)
+    {
+        return __builtin_popcountll(word);
+    }
+
+    static int lowest_bit(uint64_t word)
+    {
+        return __builtin_ctzll(word);
+    }
+
+    //bit r % 64 of words[r / 64] is set if record r is in the set
+    vector<uint64_t> words;
+};
+
+#endif // RECNO_SET_H
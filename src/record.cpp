@@ -1,4 +1,82 @@
 #include "record.h"
+#include "page.h"
+#include "error.h"
+
+static const int FILE_HEADER = TABLE_FILE_HEADER;
+static const int PAGE_HEADER = TABLE_PAGE_HEADER;
+static const int SLOT = TABLE_SLOT;
+static const char MAGIC[8] = {'D', 'S', 'D', 'B', 'T', 'B', 'L', '\0'};
+
+// reads the file header into head, throws if it is not a b-file we
+// understand
+static void read_header(fstream &f, char head[])
+{
+    f.clear();
+    f.seekg(0, ios_base::beg);
+    f.read(head, FILE_HEADER);
+    if (f.gcount() != FILE_HEADER)
+        throw error("Table file is missing its header");
+    Record::check_header(head);
+}
+
+// reads len bytes at byte offset pos
+static void read_at(fstream &f, long pos, char *buf, long len)
+{
+    f.clear();
+    f.seekg(pos, ios_base::beg);
+    f.read(buf, len);
+}
+
+// writes len bytes at byte offset pos
+static void write_at(fstream &f, long pos, const char *buf, long len)
+{
+    f.clear();
+    f.seekp(pos, ios_base::beg);
+    f.write(buf, len);
+}
+
+static long page_pos(long page)
+{
+    return page * TABLE_PAGE_SIZE;
+}
+
+// record is bigger than a page: give it a run of pages starting at
+// page number pageno, the bytes continue right after each page header.
+// returns the number of pages used
+static long write_jumbo(fstream &outs, long pageno, long recno,
+                        const string &data)
+{
+    char page[TABLE_PAGE_SIZE];
+    long len = static_cast<long>(data.size());
+    long first = TABLE_PAGE_SIZE - PAGE_HEADER - SLOT;
+    long rest = TABLE_PAGE_SIZE - PAGE_HEADER;
+    int span = static_cast<int>(1 + (len - first + rest - 1) / rest);
+
+    memset(page, 0, sizeof(page));
+    put32(page, static_cast<int>(recno));
+    put16(page + 4, 1);
+    put16(page + 6, span);
+    put32(page + 8, TABLE_PAGE_SIZE);
+    put32(page + PAGE_HEADER, PAGE_HEADER + SLOT);
+    put32(page + PAGE_HEADER + 4, static_cast<int>(len));
+    memcpy(page + PAGE_HEADER + SLOT, data.data(), first);
+    write_at(outs, page_pos(pageno), page, TABLE_PAGE_SIZE);
+
+    long done = first;
+    for (int i = 1; i < span; ++i)
+    {
+        long n = min(rest, len - done);
+        memset(page, 0, sizeof(page));
+        put32(page, static_cast<int>(recno));
+        put16(page + 4, 0);
+        put16(page + 6, i);
+        put32(page + 8, TABLE_PAGE_SIZE);
+        memcpy(page + PAGE_HEADER, data.data() + done, n);
+        write_at(outs, page_pos(pageno + i), page, TABLE_PAGE_SIZE);
+        done += n;
+    }
+    return span;
+}
 
 Record::Record()
 {
@@ -6,8 +84,8 @@ Record::Record()
     recno = -1;
     fieldCount = 0;
 
-    // set the 2d array entries to NULL
-    memset(record, 0, sizeof(record)); // Proper initialization
+    // an empty record still encodes its (zero) field count
+    data.assign(2, '\0');
 }
 
 Record::Record(vector<string> input)
@@ -16,63 +94,259 @@ Record::Record(vector<string> input)
     fieldCount = 0;
     recno = -1;
 
-    // convert input to record data
-    for (size_t i = 0; i < input.size() && i < static_cast<size_t>(MAX); ++i)
+    // field count, then the end offset of every field, then the bytes
+    int n = static_cast<int>(input.size());
+    size_t total = 0;
+    for (int i = 0; i < n; ++i)
+        total += input[i].size();
+    data.assign(2 + 4 * n, '\0');
+    data.reserve(2 + 4 * n + total);
+
+    put16(&data[0], n);
+    int end = 0;
+    for (int i = 0; i < n; ++i)
     {
-        strncpy(record[i], input[i].c_str(), MAX - 1);
-        record[i][MAX - 1] = '\0'; // Ensure null-termination
+        end += static_cast<int>(input[i].size());
+        put32(&data[2 + 4 * i], end);
+    }
+    for (int i = 0; i < n; ++i)
+    {
+        data += input[i];
         fieldCount++;
     }
 }
 
-long Record::write(fstream &outs)
+Record::Record(const RecordView &view, long recno)
+    : fieldCount(view.field_count()), recno(static_cast<int>(recno)),
+      data(view.data(), view.size())
 {
-    // makes sure it starts writing at end of file
-    outs.seekg(0, outs.end);
+}
 
-    // write to the end of the file.
-    // will return last position read
-    long pos = outs.tellp();
+// writes the header of a new b-file with no records and no data pages
+void Record::create_file(fstream &outs, int field_count)
+{
+    char page[TABLE_PAGE_SIZE];
+    memset(page, 0, sizeof(page));
+    memcpy(page, MAGIC, sizeof(MAGIC));
+    put32(page + 8, TABLE_VERSION);
+    put32(page + 12, TABLE_PAGE_SIZE);
+    put32(page + 16, field_count);
+    put32(page + 20, 0);
+    put32(page + 24, 1);
+    write_at(outs, 0, page, TABLE_PAGE_SIZE);
+    outs.flush();
+}
 
-    // writes to file
-    outs.write(&record[0][0], sizeof(record));
+void Record::check_header(const char head[])
+{
+    if (memcmp(head, MAGIC, sizeof(MAGIC)) != 0)
+        throw error("Table file is missing its header");
+    if (get32(head + 8) != TABLE_VERSION ||
+        get32(head + 12) != TABLE_PAGE_SIZE)
+        throw error("Unsupported table file version");
+}
 
-    // returns recno
-    return pos / sizeof(record);
+// number of records in a b-file
+long Record::record_count(fstream &ins)
+{
+    char head[FILE_HEADER];
+    read_header(ins, head);
+    return get32(head + 20);
 }
 
-long Record::read(fstream &ins, long recno)
+// appends the record to the last page of the b-file, or to a new page
+// if it does not fit there
+long Record::write(fstream &outs)
 {
-    long pos = recno * sizeof(record);
-    ins.seekg(pos, ios_base::beg);
-    ins.read(&record[0][0], sizeof(record));
+    char head[FILE_HEADER];
+    read_header(outs, head);
+    long records = get32(head + 20);
+    long pages = get32(head + 24);
+    long len = size();
 
-    fieldCount = 0;
-    for (int i = 0; i < MAX; i++)
+    bool placed = false;
+    if (pages > 1)
     {
-        if (record[i][0] != '\0' && isprint(static_cast<unsigned char>(record[i][0])))
+        // try the free space between the slots and the records of the
+        // last page
+        long last = pages - 1;
+        char ph[PAGE_HEADER];
+        read_at(outs, page_pos(last), ph, PAGE_HEADER);
+        int slots = get16(ph + 4);
+        int span = get16(ph + 6);
+        long freeHi = get32(ph + 8);
+        long freeLo = PAGE_HEADER + SLOT * (slots + 1);
+        if (slots > 0 && span == 1 && freeHi - len >= freeLo)
         {
-            fieldCount++;
+            long off = freeHi - len;
+            char slot[SLOT];
+            put32(slot, static_cast<int>(off));
+            put32(slot + 4, static_cast<int>(len));
+            write_at(outs, page_pos(last) + off, data.data(), len);
+            write_at(outs, page_pos(last) + PAGE_HEADER + SLOT * slots,
+                     slot, SLOT);
+            put16(ph + 4, slots + 1);
+            put32(ph + 8, static_cast<int>(off));
+            write_at(outs, page_pos(last), ph, PAGE_HEADER);
+            placed = true;
+        }
+    }
+
+    if (!placed)
+    {
+        if (PAGE_HEADER + SLOT + len <= TABLE_PAGE_SIZE)
+        {
+            // fresh page, record goes at the very end of it
+            char page[TABLE_PAGE_SIZE];
+            memset(page, 0, sizeof(page));
+            put32(page, static_cast<int>(records));
+            put16(page + 4, 1);
+            long off = TABLE_PAGE_SIZE - len;
+            put16(page + 6, 1);
+            put32(page + 8, static_cast<int>(off));
+            put32(page + PAGE_HEADER, static_cast<int>(off));
+            put32(page + PAGE_HEADER + 4, static_cast<int>(len));
+            memcpy(page + off, data.data(), len);
+            write_at(outs, page_pos(pages), page, TABLE_PAGE_SIZE);
+            pages++;
         }
         else
         {
-            break;
+            pages += write_jumbo(outs, pages, records, data);
         }
     }
-    return ins.gcount();
+
+    // one more record
+    put32(head + 20, static_cast<int>(records + 1));
+    put32(head + 24, static_cast<int>(pages));
+    write_at(outs, 0, head, FILE_HEADER);
+
+    return records;
+}
+
+// appends records a page at a time: the last page of the file is read
+// once, filled up in memory and written out whole, then the same for
+// every new page
+long Record::write_all(fstream &outs, vector<Record> &records)
+{
+    char head[FILE_HEADER];
+    read_header(outs, head);
+    long recno = get32(head + 20);
+    long pages = get32(head + 24);
+    long first = recno;
+
+    // the page being filled, 0 if there is none
+    char page[TABLE_PAGE_SIZE];
+    long pageno = 0;
+    int slots = 0;
+    long freeHi = 0;
+
+    // carry on with the last page if it holds ordinary records
+    if (pages > 1)
+    {
+        read_at(outs, page_pos(pages - 1), page, TABLE_PAGE_SIZE);
+        if (get16(page + 4) > 0 && get16(page + 6) == 1)
+        {
+            pageno = pages - 1;
+            slots = get16(page + 4);
+            freeHi = get32(page + 8);
+        }
+    }
+
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+        const string &data = records[i].data;
+        long len = static_cast<long>(data.size());
+
+        if (pageno == 0 || freeHi - len < PAGE_HEADER + SLOT * (slots + 1))
+        {
+            // the page is full, write it out
+            if (pageno != 0)
+            {
+                put16(page + 4, slots);
+                put32(page + 8, static_cast<int>(freeHi));
+                write_at(outs, page_pos(pageno), page, TABLE_PAGE_SIZE);
+                pageno = 0;
+            }
+
+            if (PAGE_HEADER + SLOT + len > TABLE_PAGE_SIZE)
+            {
+                pages += write_jumbo(outs, pages, recno, data);
+                records[i].recno = static_cast<int>(recno++);
+                continue;
+            }
+
+            memset(page, 0, sizeof(page));
+            pageno = pages++;
+            put32(page, static_cast<int>(recno));
+            put16(page + 6, 1);
+            slots = 0;
+            freeHi = TABLE_PAGE_SIZE;
+        }
+
+        // record at the end of the free space, slot after the others
+        freeHi -= len;
+        memcpy(page + freeHi, data.data(), len);
+        put32(page + PAGE_HEADER + SLOT * slots, static_cast<int>(freeHi));
+        put32(page + PAGE_HEADER + SLOT * slots + 4, static_cast<int>(len));
+        slots++;
+        records[i].recno = static_cast<int>(recno++);
+    }
+
+    if (pageno != 0)
+    {
+        put16(page + 4, slots);
+        put32(page + 8, static_cast<int>(freeHi));
+        write_at(outs, page_pos(pageno), page, TABLE_PAGE_SIZE);
+    }
+
+    put32(head + 20, static_cast<int>(recno));
+    put32(head + 24, static_cast<int>(pages));
+    write_at(outs, 0, head, FILE_HEADER);
+
+    return first;
+}
+
+// decodes field index out of the record
+string Record::getEntry(int index) const
+{
+    return string(view().entry(index));
+}
+
+int RecordView::field_count() const
+{
+    return len >= 2 ? get16(bytes) : 0;
+}
+
+// the end offset of field i - 1 is where field i starts
+string_view RecordView::entry(int index) const
+{
+    int n = field_count();
+    if (index < 0 || index >= n)
+        return string_view();
+    int base = 2 + 4 * n;
+    int start = index == 0 ? 0 : get32(bytes + 2 + 4 * (index - 1));
+    int end = get32(bytes + 2 + 4 * index);
+    return string_view(bytes + base + start, end - start);
 }
 
 // print record nicely
 void Record::print_record(ostream &outs) const
+{
+    outs << view();
+}
+
+ostream &operator<<(ostream &outs, const RecordView &r)
 {
     const int fieldWidth = 15;
     const char separator = ' ';
 
-    for (int i = 0; i < fieldCount; i++)
+    for (int i = 0; i < r.field_count(); i++)
     {
         outs << right << setw(fieldWidth) << setfill(separator)
-             << record[i];
+             << r.entry(i);
     }
+    return outs;
 }
 
 ostream &operator<<(ostream &outs, const Record &r)
@@ -2,11 +2,74 @@
 #define RECORD_H
 
 #include "mylib.h"
-
-static const int MAX = 15;
+#include <string_view>
 
 using namespace std;
 
+/*
+ * Layout of a b-file (table_name.bin), version 2:
+ *
+ *   page 0     file header: magic, version, page size, field count,
+ *              record count and page count
+ *   page 1...  slotted data pages. A page starts with a header
+ *              (first recno on the page, slot count, span, start of
+ *              the record area) followed by the slot directory, one
+ *              (offset, length) pair per record. Records are packed
+ *              from the end of the page towards the slot directory.
+ *
+ * A record that does not fit in an empty page gets a run of pages to
+ * itself: the first one has a single slot, the following ones (span
+ * tells how far back the first one is) carry the rest of its bytes.
+ *
+ * A record is its field count, the end offset of every field and then
+ * the field bytes, so fields can be any length.
+ */
+
+//size of every page in a b-file
+const int TABLE_PAGE_SIZE = 4096;
+
+//bumped whenever the layout of the b-file changes
+const int TABLE_VERSION = 2;
+
+//file header: magic (8), version (4), page size (4), field count (4),
+//record count (4), page count (4)
+const int TABLE_FILE_HEADER = 28;
+
+//page header: first recno (4), slot count (2), span (2), start of the
+//record area (4)
+const int TABLE_PAGE_HEADER = 12;
+
+//slot: offset of the record in the page (4), length (4)
+const int TABLE_SLOT = 8;
+
+/*
+ * A RecordView points at the bytes of one encoded record without
+ * copying them. It is only valid while whatever owns the bytes (a
+ * Record or a TableReader) is.
+ */
+class RecordView
+{
+public:
+    RecordView(): bytes(nullptr), len(0) {}
+    RecordView(const char* data, long size): bytes(data), len(size) {}
+
+    //number of fields in the record
+    int field_count() const;
+    //field index of the record, empty if there is no such field
+    string_view entry(int index) const;
+
+    //the encoded record
+    const char* data() const {return bytes;}
+    long size() const {return len;}
+
+    //output record, one field per column
+    friend ostream& operator <<(ostream& outs, const RecordView& r);
+
+private:
+    const char* bytes;
+    long len;
+};
+
 class Record
 {
 public:
@@ -18,16 +81,29 @@ public:
     Record();
     //single argument CTOR
     Record(vector<string> str);
+    //copies the record view points at
+    Record(const RecordView& view, long recno);
 /*
  * *************************************************************
  *               F I L E    F U N C T I O N S
  * *************************************************************
 */
-    //write to binary file
+    //append to binary file, returns the recno of the record.
+    //records are read back through a TableReader
     long write(fstream&outs);
 
-    //read from binary file
-    long read(fstream& in, long recno);
+    //appends every record in one pass, filling whole pages before
+    //writing them, and sets their recnos. returns the first recno
+    static long write_all(fstream& outs, vector<Record>& records);
+
+    //writes the header of a new, empty b-file
+    static void create_file(fstream& outs, int field_count);
+
+    //returns the number of records in a b-file
+    static long record_count(fstream& in);
+
+    //throws if head is not the header of a b-file we understand
+    static void check_header(const char head[]);
 /*
  * *************************************************************
  *             O U T P U T   F U N C T I O N S
@@ -55,9 +131,13 @@ public:
         return recno;  // Optional: to verify it worked
     }
     void setFieldCount(int fc){fieldCount = fc;}
+    //size of the record in the b-file
+    long size() const {return static_cast<long>(data.size());}
 
     //return specific entry in record
-    string getEntry(int index){return record[index];}
+    string getEntry(int index) const;
+    //the record without copying it
+    RecordView view() const {return RecordView(data.data(), size());}
 
 /*
  * *************************************************************
@@ -69,8 +149,8 @@ private:
     int fieldCount;
     //recno
     int recno;
-    //2d char array
-    char record[MAX][MAX];
+    //the encoded record: field count, field end offsets, field bytes
+    string data;
 };
 
 #endif // RECORD_H
@@ -1,7 +1,9 @@
 #include "sql.h"
 
-#include <cstring> // std::memcpy
+#include "ftokenizer.h"
 #include <vector>
+#include <future>
+#include <thread>
 #include <filesystem>
 #include <chrono>
 #include <iomanip>
@@ -119,6 +121,181 @@ static fs::path resolve_input_path(std::string filename)
     return fs::path(); // empty = not found
 }
 
+// Catalog key for a table: tables are opened relative to the current
+// directory, which changes while a batch runs, so key on the full path
+static std::string catalog_key(const std::string &name)
+{
+    return (fs::current_path() / name).string();
+}
+
+// Stream buffer that copies everything written to it into two others, so
+// a batch prints each select to the console and its output file while
+// the rows are pulled only once
+class TeeBuf : public std::streambuf
+{
+public:
+    TeeBuf(std::streambuf *a, std::streambuf *b) : first(a), second(b) {}
+
+protected:
+    int overflow(int c) override
+    {
+        if (traits_type::eq_int_type(c, traits_type::eof()))
+            return traits_type::not_eof(c);
+        int_type r1 = first->sputc(traits_type::to_char_type(c));
+        int_type r2 = second->sputc(traits_type::to_char_type(c));
+        if (traits_type::eq_int_type(r1, traits_type::eof()) ||
+            traits_type::eq_int_type(r2, traits_type::eof()))
+            return traits_type::eof();
+        return c;
+    }
+
+    std::streamsize xsputn(const char *s, std::streamsize n) override
+    {
+        std::streamsize r1 = first->sputn(s, n);
+        std::streamsize r2 = second->sputn(s, n);
+        return std::min(r1, r2);
+    }
+
+    int sync() override
+    {
+        int r1 = first->pubsync();
+        int r2 = second->pubsync();
+        return (r1 == 0 && r2 == 0) ? 0 : -1;
+    }
+
+private:
+    std::streambuf *first;
+    std::streambuf *second;
+};
+
+// Stream buffer that only counts the characters written to it, the output
+// of an explain analyze
+class CountBuf : public std::streambuf
+{
+public:
+    CountBuf() : written(0) {}
+    long count() const { return written; }
+
+protected:
+    int overflow(int c) override
+    {
+        if (!traits_type::eq_int_type(c, traits_type::eof()))
+            written++;
+        return traits_type::not_eof(c);
+    }
+
+    std::streamsize xsputn(const char *, std::streamsize n) override
+    {
+        written += n;
+        return n;
+    }
+
+private:
+    long written;
+};
+
+// Turns the profiling of operators on while it lives, so a select that
+// throws does not leave it on
+class Profiling
+{
+public:
+    explicit Profiling(bool on) : was(Operator::profiling)
+    {
+        Operator::profiling = on;
+    }
+    ~Profiling() { Operator::profiling = was; }
+
+private:
+    bool was;
+};
+
+// Turns the planning of operators on while it lives, so a plain
+// explain makes the pipeline of a select without reading its rows
+class Planning
+{
+public:
+    explicit Planning(bool on) : was(Operator::planning)
+    {
+        Operator::planning = on;
+    }
+    ~Planning() { Operator::planning = was; }
+
+private:
+    bool was;
+};
+
+// Lines of a batch parsed ahead of the one being run
+const int BATCH_AHEAD = 16;
+
+// Where there is a core to spare the statements ahead are parsed while
+// the ones before them run, otherwise just before they run
+static std::launch parse_ahead_policy()
+{
+#ifdef __EMSCRIPTEN__
+    return std::launch::deferred;
+#else
+    return std::thread::hardware_concurrency() > 1 ? std::launch::async
+                                                   : std::launch::deferred;
+#endif
+}
+
+// A line of a batch script, parsed before it is run
+struct BatchStatement
+{
+    BatchStatement() : command(false) {}
+
+    // a view into the script
+    std::string_view line;
+    // false for the lines that are only echoed, comments and the like
+    bool command;
+    Statement statement;
+    // what parsing the line threw, it is thrown again when it is run
+    std::exception_ptr failure;
+};
+
+// batch lines that do not start with an m, i, s, bulk, analyze or
+// explain are echoed
+static bool is_command(std::string_view line)
+{
+    return !line.empty() &&
+           (line[0] == 'm' || line[0] == 'i' || line[0] == 's' ||
+            line.rfind("bulk", 0) == 0 || line.rfind("analyze", 0) == 0 ||
+            line.rfind("explain", 0) == 0);
+}
+
+// Parses the next lines of script, up to BATCH_AHEAD of them and no
+// further than the end of their block, so the block they are in stays
+// good while they run and the next ones are parsed. the statements are
+// made in place and never moved
+static vector<BatchStatement> parse_ahead(FTokenizer &script)
+{
+    vector<BatchStatement> ahead;
+    ahead.reserve(BATCH_AHEAD);
+    std::string_view line;
+    while (ahead.size() < BATCH_AHEAD && script.next_line(line))
+    {
+        ahead.emplace_back();
+        BatchStatement &s = ahead.back();
+        s.line = line;
+        s.command = is_command(line);
+        if (s.command)
+        {
+            try
+            {
+                Parser temp(line);
+                s.statement = std::move(temp.get_statement());
+            }
+            catch (...)
+            {
+                s.failure = std::current_exception();
+            }
+        }
+        if (script.block_done())
+            break;
+    }
+    return ahead;
+}
+
 // -----------------------------------------------------------------------------
 // SQL implementation
 // -----------------------------------------------------------------------------
@@ -127,13 +304,18 @@ static fs::path resolve_input_path(std::string filename)
 SQL::SQL()
 {
     commNum = 0;
+    sortBudget = SORT_BUDGET;
+}
+
+SQL::~SQL()
+{
+    save_tables();
 }
 
 void SQL::run()
 {
     ensure_session_dir();
 
-    vector<string> RPN;
     [[maybe_unused]] bool debug = false;
 
     while (1)
@@ -143,74 +325,90 @@ void SQL::run()
             // get a command
             string line;
             cout << "Command: ";
-            getline(cin, line);
+            bool more = static_cast<bool>(getline(cin, line));
             fflush(stdin);
 
-            // exit if line == exit
-            if (line == "exit")
+            // exit if line == exit or there are no more lines, even if
+            // a table could not be saved
+            if (!more || line == "exit")
             {
+                bool saved = save_tables();
                 cout << "THANK YOU!" << endl;
-                exit(0);
+                exit(saved ? 0 : 1);
             }
 
-            // FIX: safe null-terminated buffer for Parser(char*)
-            std::vector<char> command(line.size() + 1);
-            std::memcpy(command.data(), line.c_str(), line.size() + 1);
-
-            // parse the command, and get ptree
-            Parser temp(command.data());
-            ptree = temp.get_parse_tree();
+            // parse the command, and get the statement
+            Parser temp(line);
+            statement = std::move(temp.get_statement());
 
-            // do shunting yard if select->values
-            if (ptree["command"][0] == "select" &&
-                !ptree["values"].empty())
+            switch (statement.command)
             {
-                RPN = temp.shuntingYard();
-            }
-
             // Creating table
-            if (ptree["command"][0] == "create" || ptree["command"][0] == "make")
-            {
-                Table t(ptree["table_name"][0], ptree["fields"]);
+            case CREATE_COMMAND:
+                create_table(statement.table, statement.fields,
+                             statement.types);
                 display_create(line);
                 commNum++;
-            }
+                break;
 
             // inserting into table
-            else if (ptree["command"][0] == "insert")
-            {
-                Table t(ptree["table_name"][0]);
-                t.insert(ptree["values"]);
+            case INSERT_COMMAND:
+                open_table(statement.table).insert(statement.values);
                 display_insert(line);
                 commNum++;
-            }
+                break;
 
-            // selecting records from table
-            else if (ptree["command"][0] == "select")
+            // inserting every row of a file into table
+            case BULK_COMMAND:
             {
-                Table t(ptree["table_name"][0]);
-                if (ptree["fields"][0] == "*")
+                int count = bulk_insert(statement.table, statement.file_name);
+                display_bulk_insert(line, count);
+                commNum++;
+                break;
+            }
+
+            // explain [analyze] select ..., or selecting records from
+            // table
+            case SELECT_COMMAND:
+                if (statement.explain)
                 {
-                    if (!ptree["values"].empty())
-                    {
-                        Table tempT = t.select_all(RPN);
-                        display_select_all(line, tempT);
-                        tempT.clean_up();
-                    }
-                    else
-                    {
-                        Table tempT = t.select_all();
-                        display_select_all(line, tempT);
-                        tempT.clean_up();
-                    }
-                    commNum++;
+                    PlanStep plan = explain(statement);
+                    display_explain(line, plan, statement.analyze);
                 }
+                else
+                {
+                    Table &t = open_table(statement.table);
+                    unique_ptr<Operator> rows = select_rows(t, statement);
+                    rows = t.project(std::move(rows), statement.columns);
+                    display_select_all(line, t, *rows);
+                }
+                commNum++;
+                break;
+
+            // recording the statistics of a table
+            case ANALYZE_COMMAND:
+            {
+                Table &t = open_table(statement.table);
+                t.analyze();
+                display_select_all(line, t, *t.statistics());
+                commNum++;
+                break;
             }
 
+            // changing a setting
+            case SET_COMMAND:
+                set_option(statement);
+                display_set(line);
+                commNum++;
+                break;
+
             // run a batch file
-            else if (ptree["command"][0] == "batch")
-            {
-                run_batch(ptree["file_name"][0]);
+            case BATCH_COMMAND:
+                run_batch(statement.file_name);
+                break;
+
+            default:
+                break;
             }
         }
         catch (exception &e)
@@ -231,11 +429,7 @@ void SQL::run_batch(string filename)
 {
     ensure_session_dir();
 
-    [[maybe_unused]] bool debug = false;
-    fstream f;
     fstream g;
-    string line = "";
-    vector<string> RPN;
 
     // Allow "FinalTest" or "FinalTest.txt"
     std::string original = filename;
@@ -250,6 +444,10 @@ void SQL::run_batch(string filename)
         throw error("Batch file not found");
     }
 
+    // Open batch input (READ), the path is absolute so it is opened
+    // before the cwd moves
+    FTokenizer script(input_path.string());
+
     // Create a per-batch folder inside the session directory
     std::string base = fs::path(original).stem().string();
     std::string batch_folder = "batch_" + make_timestamp() + "_" + sanitize_for_folder(base);
@@ -260,102 +458,120 @@ void SQL::run_batch(string filename)
     fs::path prev_cwd = fs::current_path();
     fs::current_path(batch_dir);
 
-    // Open batch input (READ)
-    f.open(input_path.string().c_str(), std::fstream::in);
-    if (f.fail())
-    {
-        fs::current_path(prev_cwd);
-        throw error("file failed to open.");
-    }
-
     // Output txt file inside the batch folder (NO subdirs in name)
     std::string out_name = fs::path(filename).stem().string() + "_output.txt";
     t_open_fileRW(g, out_name);
 
-    while (getline(f, line))
+    // the statements are run in turn while the ones after them are
+    // parsed
+    const std::launch policy = parse_ahead_policy();
+    vector<BatchStatement> ready = parse_ahead(script);
+    while (!ready.empty())
     {
-        try
+        future<vector<BatchStatement>> next =
+            async(policy, parse_ahead, std::ref(script));
+        for (size_t k = 0; k < ready.size(); ++k)
         {
-            // if our line does not start with an m, i, or s
-            if (line.empty() || (line[0] != 'm' && line[0] != 'i' && line[0] != 's'))
+            string_view line = ready[k].line;
+            try
             {
-                cout << line << endl;
-                g << line << endl;
-                continue;
-            }
-
-            // safe null-terminated buffer for Parser(char*)
-            std::vector<char> command(line.size() + 1);
-            std::memcpy(command.data(), line.c_str(), line.size() + 1);
+                if (!ready[k].command)
+                {
+                    cout << line << endl;
+                    g << line << endl;
+                    continue;
+                }
+                if (ready[k].failure)
+                    rethrow_exception(ready[k].failure);
 
-            Parser temp(command.data());
-            ptree = temp.get_parse_tree();
+                statement = std::move(ready[k].statement);
 
-            if (ptree["command"][0] == "select" &&
-                !ptree["values"].empty())
-            {
-                RPN = temp.shuntingYard();
-            }
-
-            if (ptree["command"][0] == "create" || ptree["command"][0] == "make")
-            {
-                Table t(ptree["table_name"][0], ptree["fields"]);
-                display_create(line);
-                display_create(line, g);
-                commNum++;
-            }
-            else if (ptree["command"][0] == "insert")
-            {
-                Table t(ptree["table_name"][0]);
-                t.insert(ptree["values"]);
-                display_insert(line);
-                display_insert(line, g);
-                commNum++;
-            }
-            else if (ptree["command"][0] == "select")
-            {
-                Table t(ptree["table_name"][0]);
-                if (ptree["fields"][0] == "*")
+                switch (statement.command)
+                {
+                case CREATE_COMMAND:
+                    create_table(statement.table, statement.fields,
+                                 statement.types);
+                    display_create(line);
+                    display_create(line, g);
+                    commNum++;
+                    break;
+                case INSERT_COMMAND:
+                    open_table(statement.table).insert(statement.values);
+                    display_insert(line);
+                    display_insert(line, g);
+                    commNum++;
+                    break;
+                case BULK_COMMAND:
                 {
-                    if (!ptree["values"].empty())
+                    int count = bulk_insert(statement.table,
+                                            statement.file_name);
+                    display_bulk_insert(line, count);
+                    display_bulk_insert(line, count, g);
+                    commNum++;
+                    break;
+                }
+                case SELECT_COMMAND:
+                    if (statement.explain)
                     {
-                        Table tempT = t.select_all(RPN);
-                        display_select_all(line, tempT);
-                        display_select_all(line, tempT, g);
-                        tempT.clean_up();
+                        PlanStep plan = explain(statement);
+                        display_explain(line, plan, statement.analyze);
+                        display_explain(line, plan, statement.analyze, g);
                     }
                     else
                     {
-                        Table tempT = t.select_all();
-                        display_select_all(line, tempT);
-                        display_select_all(line, tempT, g);
-                        tempT.clean_up();
+                        Table &t = open_table(statement.table);
+                        unique_ptr<Operator> rows = select_rows(t, statement);
+                        rows = t.project(std::move(rows), statement.columns);
+                        // rows can only be pulled once, print them to both
+                        TeeBuf tee(cout.rdbuf(), g.rdbuf());
+                        ostream both(&tee);
+                        display_select_all(line, t, *rows, both);
                     }
                     commNum++;
+                    break;
+                case ANALYZE_COMMAND:
+                {
+                    Table &t = open_table(statement.table);
+                    t.analyze();
+                    unique_ptr<Operator> rows = t.statistics();
+                    TeeBuf tee(cout.rdbuf(), g.rdbuf());
+                    ostream both(&tee);
+                    display_select_all(line, t, *rows, both);
+                    commNum++;
+                    break;
+                }
+                case SET_COMMAND:
+                    set_option(statement);
+                    display_set(line);
+                    display_set(line, g);
+                    commNum++;
+                    break;
+                case BATCH_COMMAND:
+                    // Nested batch: will create another folder inside session
+                    run_batch(statement.file_name);
+                    break;
+                default:
+                    break;
                 }
             }
-            else if (ptree["command"][0] == "batch")
+            catch (exception &e)
             {
-                // Nested batch: will create another folder inside session
-                run_batch(ptree["file_name"][0]);
+                cout << e.what() << endl
+                     << endl;
+                g << e.what() << endl
+                  << endl;
+            }
+            catch (...)
+            {
+                cout << endl
+                     << "An unknown error has occured." << endl
+                     << endl;
+                g << endl
+                  << "An unknown error has occured." << endl
+                  << endl;
             }
         }
-        catch (exception &e)
-        {
-            cout << e.what() << endl
-                 << endl;
-            g << e.what() << endl
-              << endl;
-        }
-        catch (...)
-        {
-            cout << endl
-                 << "An unknown error has occured." << endl
-                 << endl;
-            g << endl
-              << "An unknown error has occured." << endl
-              << endl;
-        }
+        ready = next.get();
     }
 
     cout << "---------------------------" << endl;
@@ -363,21 +579,289 @@ void SQL::run_batch(string filename)
     g << "---------------------------" << endl;
     g << "End of Batch Process" << endl;
 
-    f.close();
     g.close();
 
+    // the batch folder is done with, so are the tables that live in it
+    close_tables(batch_dir.string());
+
     // Restore previous working directory (session dir)
     fs::current_path(prev_cwd);
 
     cout << "Batch outputs saved to: " << batch_dir.string() << endl;
 }
 
+// loads every row of a file into a table. the file is looked up the
+// same way as a batch file
+int SQL::bulk_insert(const string &table_name, string file_name)
+{
+    if (file_name.find('.') > file_name.size())
+        file_name += ".txt";
+    fs::path input_path = resolve_input_path(file_name);
+    if (input_path.empty())
+        throw error("Load file not found");
+    return open_table(table_name).load(input_path.string());
+}
+
+// runs the select in statement against t: the where clause (if there
+// is one), then the order by and the limit
+unique_ptr<Operator> SQL::select_rows(Table &t, const Statement &statement)
+{
+    const vector<string> &where = statement.where;
+    long limit = statement.limit;
+    long offset = statement.offset;
+
+    // aggregates: the column list has count(*), sum(salary), ...
+    bool grouped = !statement.group_by.empty();
+    for (size_t i = 0; i < statement.columns.size(); ++i)
+        if (statement.columns[i].find('(') != string::npos)
+            grouped = true;
+
+    unique_ptr<Operator> rows;
+    if (!statement.join.empty())
+    {
+        if (grouped)
+            throw error("Invalid Input: aggregates are not supported on a join");
+        rows = join_rows(t, statement);
+    }
+    else if (grouped)
+    {
+        if (!statement.order_by.empty() &&
+            statement.order_by != statement.group_by)
+            throw error("Invalid Input: order by needs the group by field");
+        rows = t.aggregate(where, statement.columns, statement.group_by,
+                           statement.descending);
+    }
+    else if (!statement.order_by.empty())
+        rows = t.select_ordered(where, statement.order_by,
+                                statement.descending,
+                                limit < 0 ? -1 : offset + limit);
+    else
+        rows = where.empty() ? t.select_all() : t.select_all(where);
+    if (limit < 0 && offset == 0)
+        return rows;
+    return unique_ptr<Operator>(new Limit(std::move(rows), offset, limit));
+}
+
+// the plan is made the way the select would make it. for a plain
+// explain only the index lookups that pick it are done: no record is
+// read, and the rows of a join or of groups are left to the statistics.
+// explain analyze runs the select and prints its rows into a CountBuf.
+// opening a table that is not open yet is a step of its own: it reads
+// the field list and the statistics
+PlanStep SQL::explain(const Statement &statement)
+{
+    bool analyze = statement.analyze;
+    Profiling profiling(analyze);
+    Planning planning(!analyze);
+    const string &name = statement.table;
+    bool open = tables.find(catalog_key(name)) != tables.end();
+
+    PlanStep output;
+    output.what = "output";
+    {
+        Timer timer(output.ms);
+        PlanStep opening;
+        Table *t;
+        {
+            Timer openTimer(opening.ms);
+            t = &open_table(name);
+        }
+        if (!open)
+        {
+            opening.what = "open table " + name;
+            opening.rows = opening.planned = -1;
+            output.inputs.push_back(opening);
+        }
+
+        unique_ptr<Operator> rows = select_rows(*t, statement);
+        rows = t->project(std::move(rows), statement.columns);
+        if (analyze)
+        {
+            CountBuf sink;
+            ostream nowhere(&sink);
+            t->print_rows(nowhere, *rows);
+            output.bytes = sink.count();
+        }
+        output.inputs.push_back(rows->plan());
+        output.rows = output.inputs.back().rows;
+        output.planned = output.inputs.back().planned;
+    }
+    return output;
+}
+
+// fields of a join are table.field, or just field if the other table
+// has no field called that
+unique_ptr<Operator> SQL::join_rows(Table &t, const Statement &statement)
+{
+    Table &inner = open_table(statement.join);
+    const string &outerName = statement.table;
+    const string &innerName = statement.join;
+
+    // 0 if name is a field of t, 1 if it is one of inner. field is the
+    // name without its table
+    auto side_of = [&](const string &name, string &field)
+    {
+        size_t dot = name.find('.');
+        if (dot != string::npos)
+        {
+            string table = name.substr(0, dot);
+            field = name.substr(dot + 1);
+            if (table == outerName)
+                return 0;
+            if (table == innerName)
+                return 1;
+            throw error("Invalid Input: field of a table not in the join");
+        }
+        field = name;
+        if (t.has_field(name))
+            return 0;
+        if (inner.has_field(name))
+            return 1;
+        throw error("Field does not exist");
+    };
+
+    // on a.x = b.y, either way around. a self join takes them in order
+    string field;
+    string innerField;
+    int left = side_of(statement.on[0], field);
+    int right = side_of(statement.on[1], innerField);
+    if (left == right && outerName != innerName)
+        throw error("Invalid Input: join needs a field of each table");
+    if (left == 1 && right == 0)
+        swap(field, innerField);
+
+    // the where clause is run on the one table its fields belong to.
+    // the field of a predicate is 2 tokens before its operator, 3
+    // before a fused range (see Parser::fuseRanges)
+    vector<string> RPN = statement.where;
+    int whereSide = 0;
+    bool seen = false;
+    for (size_t i = 0; i < RPN.size(); ++i)
+    {
+        bool range = RPN[i] == "[]" || RPN[i] == "[)" ||
+                     RPN[i] == "(]" || RPN[i] == "()";
+        bool relational = RPN[i] == "=" || RPN[i] == "<" || RPN[i] == ">" ||
+                          RPN[i] == "<=" || RPN[i] == ">=";
+        if (!range && !relational)
+            continue;
+        string name = RPN[i - (range ? 3 : 2)];
+        int side = side_of(name, RPN[i - (range ? 3 : 2)]);
+        if (seen && side != whereSide)
+            throw error("Invalid Input: a where on a join can only use the fields of one table");
+        whereSide = side;
+        seen = true;
+    }
+
+    return t.join(inner, field, innerField,
+                  whereSide == 0 ? RPN : vector<string>(),
+                  whereSide == 1 ? RPN : vector<string>());
+}
+
+// returns the open table with this name, loading it the first time
+Table &SQL::open_table(const string &name)
+{
+    string key = catalog_key(name);
+    map<string, Table>::iterator it = tables.find(key);
+    if (it == tables.end())
+    {
+        // Table(name) throws if the table does not exist, in which case
+        // nothing is added to the catalog
+        it = tables.emplace(std::piecewise_construct,
+                            std::forward_as_tuple(key),
+                            std::forward_as_tuple(name))
+                 .first;
+        it->second.set_sort_budget(sortBudget);
+    }
+    return it->second;
+}
+
+// creates a table, replacing any open table with the same name
+Table &SQL::create_table(const string &name, const vector<string> &fields,
+                         const vector<string> &types)
+{
+    string key = catalog_key(name);
+    tables.erase(key);
+    Table &t = tables.emplace(std::piecewise_construct,
+                              std::forward_as_tuple(key),
+                              std::forward_as_tuple(name, fields, types))
+                   .first->second;
+    t.set_sort_budget(sortBudget);
+    return t;
+}
+
+// set sort budget = <bytes>: the budget of every open table and of the
+// ones opened after
+void SQL::set_option(const Statement &statement)
+{
+    if (statement.setting != "sort budget")
+        throw error("Invalid Input: the only setting is sort budget");
+    const string &value = statement.setting_value;
+    if (value.empty() || value.size() > 12 ||
+        value.find_first_not_of("0123456789") != string::npos ||
+        atoll(value.c_str()) == 0)
+        throw error("Invalid Input: sort budget needs a number of bytes");
+
+    sortBudget = static_cast<size_t>(atoll(value.c_str()));
+    for (map<string, Table>::iterator it = tables.begin();
+         it != tables.end(); ++it)
+        it->second.set_sort_budget(sortBudget);
+}
+
+// writes the indices and the statistics of t, and reports it if they
+// could not be written
+static bool save_table(Table &t)
+{
+    try
+    {
+        t.save_indices();
+        t.save_stats();
+        return true;
+    }
+    catch (exception &e)
+    {
+        cout << "Could not save table " << t.getName() << ": " << e.what()
+             << endl;
+        return false;
+    }
+}
+
+// saves and drops the open tables whose files live under dir
+void SQL::close_tables(const string &dir)
+{
+    string prefix = (fs::path(dir) / "").string();
+    map<string, Table>::iterator it = tables.begin();
+    while (it != tables.end())
+    {
+        if (it->first.compare(0, prefix.size(), prefix) == 0)
+        {
+            save_table(it->second);
+            it = tables.erase(it);
+        }
+        else
+            ++it;
+    }
+}
+
+// writes the indices of every open table. a table that cannot be
+// saved does not keep the ones after it from being saved
+bool SQL::save_tables()
+{
+    bool saved = true;
+    for (map<string, Table>::iterator it = tables.begin();
+         it != tables.end(); ++it)
+    {
+        if (!save_table(it->second))
+            saved = false;
+    }
+    return saved;
+}
+
 // displays a message after create
-void SQL::display_create(string command, ostream &outs)
+void SQL::display_create(string_view command, ostream &outs)
 {
     outs << "[" << commNum << "] ";
     outs << command << endl;
-    outs << "Table Created: " << ptree["table_name"][0] << endl
+    outs << "Table Created: " << statement.table << endl
          << endl
          << endl;
 
@@ -386,11 +870,38 @@ void SQL::display_create(string command, ostream &outs)
 }
 
 // displays a message after insert
-void SQL::display_insert(string command, ostream &outs)
+void SQL::display_insert(string_view command, ostream &outs)
+{
+    outs << "[" << commNum << "] ";
+    outs << command << endl;
+    outs << "SQL::run: inserted into table: " << statement.table << endl
+         << endl
+         << endl;
+
+    outs << "SQL: DONE." << endl
+         << endl;
+}
+
+// displays a message after set
+void SQL::display_set(string_view command, ostream &outs)
+{
+    outs << "[" << commNum << "] ";
+    outs << command << endl;
+    outs << "Sort budget: " << sortBudget << " bytes" << endl
+         << endl
+         << endl;
+
+    outs << "SQL: DONE." << endl
+         << endl;
+}
+
+// displays a message after bulk insert
+void SQL::display_bulk_insert(string_view command, int count, ostream &outs)
 {
     outs << "[" << commNum << "] ";
     outs << command << endl;
-    outs << "SQL::run: inserted into table: " << ptree["table_name"][0] << endl
+    outs << "SQL::run: inserted " << count << " records into table: "
+         << statement.table << endl
          << endl
          << endl;
 
@@ -399,13 +910,30 @@ void SQL::display_insert(string command, ostream &outs)
 }
 
 // displays a message after select all
-void SQL::display_select_all(string command, Table t, ostream &outs)
+void SQL::display_select_all(string_view command, Table &t, Operator &rows,
+                             ostream &outs)
+{
+    outs << "[" << commNum << "] ";
+    outs << command << endl
+         << endl;
+
+    t.print_rows(outs, rows);
+    outs << endl
+         << endl;
+    outs << "SQL: DONE." << endl
+         << endl;
+}
+
+// displays the plan of an explain
+void SQL::display_explain(string_view command, const PlanStep &plan,
+                          bool analyzed, ostream &outs)
 {
     outs << "[" << commNum << "] ";
     outs << command << endl
          << endl;
 
-    outs << t << endl
+    print_plan(outs, plan, analyzed);
+    outs << endl
          << endl;
     outs << "SQL: DONE." << endl
          << endl;
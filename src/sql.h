@@ -15,6 +15,8 @@ public:
 */
     //constructor
     SQL();
+    //saves the indices of every open table
+    ~SQL();
 /*
  * *************************************************************
  *              R U N    F U N C T I O N S
@@ -31,11 +33,21 @@ public:
  * *************************************************************
 */
     //displays a message after create
-    void display_create(string command, ostream& outs = cout);
+    void display_create(string_view command, ostream& outs = cout);
     //displays a message after insert
-    void display_insert(string command, ostream& outs = cout);
-    //displays a message after select all
-    void display_select_all(string command, Table t, ostream& outs = cout);
+    void display_insert(string_view command, ostream& outs = cout);
+    //displays a message after bulk insert
+    void display_bulk_insert(string_view command, int count,
+                             ostream& outs = cout);
+    //displays a message after select all, followed by the rows
+    void display_select_all(string_view command, Table& t, Operator& rows,
+                            ostream& outs = cout);
+    //displays the plan of an explain, with the counts and times of the
+    //run if it was analyzed
+    void display_explain(string_view command, const PlanStep& plan,
+                         bool analyzed, ostream& outs = cout);
+    //displays a message after set
+    void display_set(string_view command, ostream& outs = cout);
 /*
  * *************************************************************
  *       T E X T     F I L E     F U N C T I O N S
@@ -46,17 +58,57 @@ public:
     //opens a text file for reading and writing
     void t_open_fileRW(fstream& f, const string file_name);
 
+/*
+ * *************************************************************
+ *              T A B L E   C A T A L O G
+ * *************************************************************
+*/
+    //returns the open table with this name, loading it from disk
+    //the first time it is used
+    Table& open_table(const string& name);
+    //creates a new table and keeps it open in the catalog. types
+    //holds the type of each field
+    Table& create_table(const string& name, const vector<string>& fields,
+                        const vector<string>& types = vector<string>());
+    //the rows of the select statement
+    unique_ptr<Operator> select_rows(Table& t, const Statement& statement);
+    //the plan of the select statement (explain), made without reading
+    //a record. for explain analyze the select is run too, its rows
+    //printed nowhere, and every step is counted and timed
+    PlanStep explain(const Statement& statement);
+    //inserts every row of a file into a table, returns the number
+    //of rows inserted
+    int bulk_insert(const string& table_name, string file_name);
+    //applies a set statement. the one setting is the sort budget:
+    //set sort budget = <bytes>
+    void set_option(const Statement& statement);
+    //saves and drops every open table that lives under the given
+    //directory
+    void close_tables(const string& dir);
+    //writes the indices of every open table to their index files.
+    //returns false if one of them could not be saved
+    bool save_tables();
+
 /*
  * *************************************************************
  *              P R I V A T E   V A R I A B L E S
  * *************************************************************
 */
 private:
+    //the rows of a select ... from t join ..., its where clause is on
+    //the fields of either table
+    unique_ptr<Operator> join_rows(Table& t, const Statement& statement);
     //command number
     int commNum;
+    //bytes of sort keys a select keeps in memory before it spills
+    //runs to disk, given to every open table
+    size_t sortBudget;
     //a command
     string command;
-    //A parse tree that holds our tokens
-    MMap<string, string> ptree;
+    //what the parser made of the command
+    Statement statement;
+    //open tables keyed by the absolute path of their files, so the
+    //indices stay live between commands instead of being rebuilt
+    map<string, Table> tables;
 };
 #endif // SQL_H
@@ -0,0 +1,62 @@
+#ifndef STATEMENT_H
+#define STATEMENT_H
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+//what a statement does. make table and create table are both CREATE
+enum command_kinds {NO_COMMAND, CREATE_COMMAND, INSERT_COMMAND,
+                    BULK_COMMAND, SELECT_COMMAND, ANALYZE_COMMAND,
+                    BATCH_COMMAND, SET_COMMAND};
+
+/*
+ * A Statement is what the parser makes of a command in its one pass
+ * over the tokens: the kind of command, and the parts of it that kind
+ * of command has, each in a field of its own. The parts a command does
+ * not have are left empty.
+ */
+struct Statement
+{
+    Statement(): command(NO_COMMAND), descending(false), limit(-1),
+                 offset(0), explain(false), analyze(false) {}
+
+    command_kinds command;
+    //the table of the command, the outer one of a join
+    string table;
+
+    //make table: the fields, and the type of each (string unless one
+    //is given)
+    vector<string> fields;
+    vector<string> types;
+    //insert into: the values of the row
+    vector<string> values;
+    //bulk insert and batch: the file read
+    string file_name;
+
+    //select: the columns as they were written, * or lname or count(*)
+    vector<string> columns;
+    //the where clause in RPN with its ranges fused (see
+    //Parser::fuseRanges), empty if there is none
+    vector<string> where;
+    //join: the inner table, and the two fields of the on
+    string join;
+    vector<string> on;
+    //empty if there is no group by / order by
+    string group_by;
+    string order_by;
+    bool descending;
+    //-1 if there is no limit
+    long limit;
+    long offset;
+    //explain select, explain analyze select
+    bool explain;
+    bool analyze;
+
+    //set: the setting, its words joined by blanks, and its value
+    string setting;
+    string setting_value;
+};
+
+#endif // STATEMENT_H
@@ -2,63 +2,97 @@
 #define STOKENIZER_H
 
 #include "token.h"
-#include "state_machine.h"
 #include "error.h"
+#include <string_view>
+
+//the classes a char can be in, or'ed together in CharClasses
+enum char_classes {DIGIT_CHAR = 1, LETTER_CHAR = 2, WORD_CHAR = 4,
+                   PUNCT_CHAR = 8, SPACE_CHAR = 16, QUOT_CHAR = 32};
+
+/*
+ * The class of every one of the 256 chars. A letter starts a word, a
+ * word char carries one on: letters, the accents ~ and ^, and every
+ * byte from 128 up, so a UTF-8 word is one token. Made at compile time.
+ */
+struct CharClasses
+{
+    constexpr CharClasses(): of()
+    {
+        mark("0123456789", DIGIT_CHAR);
+        mark("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ",
+             LETTER_CHAR | WORD_CHAR);
+        for (int c = 128; c < 256; ++c)
+            of[c] = LETTER_CHAR | WORD_CHAR;
+        mark("~^", WORD_CHAR);
+        mark(".!@?,_#&$^%+()*><-:;=\'", PUNCT_CHAR);
+        mark(" \t\n\r\v\f", SPACE_CHAR);
+        mark("\"", QUOT_CHAR);
+    }
+
+    constexpr void mark(const char* chars, unsigned char cls)
+    {
+        for (; *chars != '\0'; ++chars)
+            of[static_cast<unsigned char>(*chars)] |= cls;
+    }
+
+    unsigned char of[256];
+};
 
-
-const int MAX_BUFFER = 200;
-
+/*
+ * An STokenizer cuts a string into tokens: numbers (12, 3.5), words,
+ * runs of punctuation, runs of white space and runs of quotes. Any
+ * other char is a token of its own, of UNKNOWN type.
+ *
+ * It scans a string_view of any length and does not copy it: the tokens
+ * are views into it, so the string has to outlive them.
+ */
 class STokenizer
 {
 public:
 
-    //Postcondition: sets _pos to zero. Sets _buffer to empty
-    //creates adjacency matrix for desired states.
-    STokenizer();
+    //Postcondition: the stokenizer has nothing to scan
+    STokenizer(): _pos(0) {}
 
-    //Postcondition: _buffer memeber variable has been initialized
-    //to the value of str. _pos is still zero.
-    //creates adjacency matrix for desired states.
-    STokenizer(char str[]);
+    //Postcondition: the stokenizer will scan str from its start
+    explicit STokenizer(string_view str);
 
     //Postcondition: returns true if there are no more tokens
-    bool done();
+    bool done() const {return _pos >= _source.size();}
 
     //Postcondition: returns true if there are more tokens
-    bool more();
+    bool more() const {return _pos < _source.size();}
 
     //Postcondition: extracts one token (similar tot he way cin >> work)
     //from Stokenizer s and stores the string
     //and its type in a Token object
     friend STokenizer &operator >> (STokenizer&s, Token& t);
 
-    //Postcondition: sets a new string str
-    //into the _buffer member variable
-    void set_string(char str[]);
+    //Postcondition: the stokenizer will scan str from its start
+    void set_string(string_view str);
 
     //Postcondition: outputs everything in the STokneizer, for debugging
-    friend ostream &operator << (ostream& outs, STokenizer&s);
+    friend ostream &operator << (ostream& outs, const STokenizer&s);
 
 private:
 
-    //Postcondition: create state machines for all the types we will
-    //recognize: doubles, words, etc
-    void make_table(int table[][MAX_COLUMNS]);
+    //Postcondition: the classes of the char at pos
+    unsigned char class_of(size_t pos) const
+    {
+        return classes.of[static_cast<unsigned char>(_source[pos])];
+    }
 
-    //Precondition: we are given a starting state,
-    //and _buffer has a phrase in it
-    //Postconditon: extract the longest string that match
-    //one of the acceptable token types
-    bool get_token(int start_state, string& token);
+    //Postcondition: the first position from pos on whose char is not
+    //of class cls, or the end
+    size_t skip(size_t pos, unsigned char cls) const;
 
-    //holds the input string
-    char _buffer[MAX_BUFFER];
+    //the string being scanned
+    string_view _source;
 
     //_pos maintains the current position in the string
-    int _pos;
+    size_t _pos;
 
-    //our state machines
-    static int _table[MAX_ROWS][MAX_COLUMNS];
+    //the class of each char
+    static const CharClasses classes;
 
 };
 
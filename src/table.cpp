@@ -1,5 +1,6 @@
 #include "table.h"
 #include "file_functions.h"
+#include "group_table.h"
 
 // loads existing table
 Table::Table(string name)
@@ -11,6 +12,7 @@ Table::Table(string name)
     if (!file_exists(binName.c_str()))
         throw error("FILE DOES NOT EXIST");
     recordCount = 0;
+    sortBudget = SORT_BUDGET;
 
     // set filename to name
     filename = name;
@@ -24,57 +26,61 @@ Table::Table(string name)
     txt >> temp;
     while (!txt.eof())
     {
-        fieldList.push_back(temp);
+        // a typed field is saved as name:type
+        size_t colon = temp.find(':');
+        if (colon == string::npos)
+        {
+            fieldList.push_back(temp);
+            types.push_back(STRING_COLUMN);
+        }
+        else
+        {
+            fieldList.push_back(temp.substr(0, colon));
+            types.push_back(column_type(temp.substr(colon + 1)));
+        }
         count++;
         txt >> temp;
     }
     txt.close();
 
-    // push back appropriate amount of empty mmaps
+    // push back appropriate amount of empty mmaps. They are filled
+    // from their index files the first time a field is used
     for (size_t i = 0; i < fieldList.size(); ++i)
     {
         indices.push_back(MMap<string, int>());
+        loaded.push_back(false);
+        saved.push_back(0);
     }
 
-    // fill indices mmaps
+    // the record count is kept in the header of the b-file
     fstream f;
     open_fileRW(f, binName.c_str());
-    Record r;
-    vector<string> fields;
-    int recno = 0;
-
-    // read a record
-    r.read(f, recno);
-    fields = get_field_values(r);
-    while (f.gcount())
-    {
-
-        // go through field values of each record and
-        // insert them in their right place
-        for (size_t j = 0; j < fields.size(); j++)
-        {
-            indices[j][fields[j]] += recno;
-        }
-        recno++;
-        r.read(f, recno);
-        fields = get_field_values(r);
-    }
-    recordCount = recno;
+    recordCount = static_cast<int>(Record::record_count(f));
     f.close();
+
+    // statistics of more records than there are belong to some older
+    // table of this name
+    stats.load(stats_name(), static_cast<int>(fieldList.size()));
+    if (stats.row_count() > recordCount)
+        stats = TableStats();
 }
 
 // creates table with name and field list
-Table::Table(const string name, vector<string> field_list)
+Table::Table(const string name, vector<string> field_list,
+             vector<string> type_list)
 {
 
     recordCount = 0;
+    sortBudget = SORT_BUDGET;
     // save file name
     filename = name;
 
-    // save field list values
+    // save field list values and their types
     for (unsigned int i = 0; i < field_list.size(); ++i)
     {
         fieldList += field_list[i];
+        types.push_back(i < type_list.size() ? column_type(type_list[i])
+                                             : STRING_COLUMN);
     }
 
     // create a file called table_field_values.txt
@@ -82,23 +88,43 @@ Table::Table(const string name, vector<string> field_list)
     // we can re-access it
     fstream txt;
     string txtname = name;
-    t_open_fileRW(txt, txtname += "_fields.txt");
+    txt.open(txtname += "_fields.txt", std::fstream::out | std::fstream::trunc);
+    if (txt.fail())
+        throw error("Could not create table");
 
-    // push appropriate ammount of empty mmaps
+    // push appropriate ammount of empty mmaps. a new table has no
+    // records, so its (empty) indices are already up to date
     for (size_t i = 0; i < field_list.size(); ++i)
     {
-        txt << field_list[i] << " ";
+        txt << field_list[i];
+        if (types[i] != STRING_COLUMN)
+            txt << ":" << column_type_name(types[i]);
+        txt << " ";
         indices.push_back(MMap<string, int>());
+        loaded.push_back(true);
+        saved.push_back(0);
+        // drop index files left over from an older table of this name
+        remove(index_name(i).c_str());
     }
     txt.close();
+    remove(stats_name().c_str());
 
     // create empty bin file
     fstream f;
     string binName = filename;
     if (binName.find('.') > binName.size())
         binName += ".bin";
-    open_fileRW(f, binName.c_str());
+    open_fileW(f, binName.c_str());
+    Record::create_file(f, static_cast<int>(field_list.size()));
     f.close();
+    TableReader::forget(binName);
+}
+
+// a value is only stored if its key fits in a page of the index file
+static void check_key_size(const string &key)
+{
+    if (key.size() > static_cast<size_t>(INDEX_MAX_KEY))
+        throw error("Value is too long to index");
 }
 
 // inserts values into table
@@ -107,174 +133,649 @@ void Table::insert(const vector<string> field_values)
     if (field_values.size() != fieldList.size())
         throw error("Not enough values were entered");
 
+    // make the keys first, so a value of the wrong type is caught
+    // before anything is written
+    vector<string> keys;
+    for (size_t i = 0; i < field_values.size(); ++i)
+    {
+        keys.push_back(index_key(i, field_values[i]));
+        check_key_size(keys.back());
+    }
+
+    // a key the loaded index does not have yet is a new distinct value
+    vector<bool> fresh(keys.size());
+    if (stats.exists())
+        for (size_t i = 0; i < keys.size(); ++i)
+            fresh[i] = loaded[i] && !indices[i].contains(keys[i]);
+
     Record temp(field_values);
 
     save_list(temp);
 
     // go through list of indexes insert values of each
-    // field and there recno into the appropriate multimap
+    // field and there recno into the appropriate multimap.
+    // indices that are not loaded pick the record up from the
+    // b-file when they are loaded
     for (size_t i = 0; i < field_values.size(); ++i)
     {
-        // indices.push_back(MMap<string, int>());
-        indices[i][field_values[i]] += temp.getRecno();
+        if (loaded[i])
+            indices[i][keys[i]] += temp.getRecno();
     }
     recordCount += 1;
+
+    // only a row that was stored is counted
+    if (stats.exists())
+        stats.add(keys, fresh);
 }
 
-// get all records from table and sets them to a temp table
-Table Table::select_all()
+// inserts many rows at once: the records are appended with one open of
+// the b-file, then every loaded index is rebuilt once
+void Table::insert_many(const vector<vector<string>> &rows)
 {
-    Record r;
-    string name = filename + "_temp_";
-    name += to_string(getTemp());
-
-    Table tempT(name, fieldList);
-    vector<string> fields;
+    vector<Record> records;
+    records.reserve(rows.size());
+    for (size_t r = 0; r < rows.size(); ++r)
+    {
+        if (rows[r].size() != fieldList.size())
+            throw error("Not enough values were entered");
+        // check the typed fields and the key sizes before anything is
+        // written
+        for (size_t i = 0; i < fieldList.size(); ++i)
+            check_key_size(types[i] != STRING_COLUMN
+                               ? index_key(i, rows[r][i])
+                               : rows[r][i]);
+        records.push_back(Record(rows[r]));
+    }
 
-    // read from current tables b-file
-    fstream f;
     string binName = filename;
     if (binName.find('.') > binName.size())
         binName += ".bin";
+    fstream f;
     open_fileRW(f, binName.c_str());
+    Record::write_all(f, records);
+    f.close();
+    if (f.fail())
+        throw error("Could not write table file");
 
-    int recno = 0;
-    r.read(f, recno);
-    fields = get_field_values(r);
+    // as with insert, a key is new if neither the loaded index nor an
+    // earlier row of this batch has it
+    if (stats.exists())
+    {
+        vector<GroupTable> seen(fieldList.size());
+        vector<string> keys(fieldList.size());
+        vector<bool> fresh(fieldList.size());
+        for (size_t r = 0; r < rows.size(); ++r)
+        {
+            for (size_t i = 0; i < fieldList.size(); ++i)
+            {
+                keys[i] = index_key(i, rows[r][i]);
+                fresh[i] = loaded[i] && !indices[i].contains(keys[i]) &&
+                           seen[i].find(keys[i]) < 0;
+                seen[i].insert(keys[i]);
+            }
+            stats.add(keys, fresh);
+        }
+    }
 
-    // insert each record into temp T
-    while (f.gcount())
+    // as with insert, indices that are not loaded pick the records up
+    // from the b-file when they are loaded
+    vector<pair<string, int>> added;
+    for (size_t i = 0; i < fieldList.size(); ++i)
     {
-        tempT.insert(fields);
-        recno++;
-        r.read(f, recno);
-        fields = get_field_values(r);
+        if (!loaded[i])
+            continue;
+        added.clear();
+        added.reserve(rows.size());
+        for (size_t r = 0; r < rows.size(); ++r)
+            added.push_back(make_pair(index_key(i, rows[r][i]),
+                                      records[r].getRecno()));
+        merge_index(i, added);
     }
-    f.close();
+    recordCount += static_cast<int>(rows.size());
+}
+
+// reads the rows of a load file and inserts them in chunks, so a big
+// file never has to be held in memory all at once
+int Table::load(const string &file_name)
+{
+    const size_t CHUNK = 100000;
+
+    ifstream in(file_name);
+    if (in.fail())
+        throw error("Could not open load file");
+
+    int count = 0;
+    string line;
+    vector<vector<string>> rows;
+    rows.reserve(CHUNK);
+    while (getline(in, line))
+    {
+        vector<string> values = split_values(line);
+        if (values.empty())
+            continue;
+        rows.push_back(values);
+        if (rows.size() == CHUNK)
+        {
+            insert_many(rows);
+            count += static_cast<int>(rows.size());
+            rows.clear();
+        }
+    }
+    insert_many(rows);
+    count += static_cast<int>(rows.size());
+    return count;
+}
+
+// scans every record of the table
+unique_ptr<Operator> Table::select_all()
+{
+    string binName = filename;
+    if (binName.find('.') > binName.size())
+        binName += ".bin";
+    return unique_ptr<Operator>(new TableScan(binName, recordCount));
+}
+
+// looks up the records that RPN finds
+unique_ptr<Operator> Table::select_all(vector<string> RPN)
+{
+    string binName = filename;
+    if (binName.find('.') > binName.size())
+        binName += ".bin";
+    PlanStep how;
+    vector<int> found = find_recnos(RPN, &how);
+    unique_ptr<Operator> rows(new IndexLookup(binName, found));
+    rows->found_by(std::move(how));
+    return rows;
+}
 
-    // return tempT
-    return tempT;
+// hands the steps under how (the indices that had to be loaded) to
+// rows, for explain
+static void found_by_all(Operator &rows, PlanStep &how)
+{
+    for (size_t i = 0; i < how.inputs.size(); ++i)
+        rows.found_by(std::move(how.inputs[i]));
 }
 
-// Evalutes "RPN"
-Table Table::select_all(vector<string> RPN)
+// the records RPN finds (all of them if it is empty) sorted on field.
+// the whole table, or a good part of it, is read in the order of the
+// field's index. fewer records are sorted on their own
+unique_ptr<Operator> Table::select_ordered(const vector<string> &RPN,
+                                           const string &field,
+                                           bool descending,
+                                           long wanted)
 {
-    string name = filename + "_temp_";
-    name += to_string(getTemp());
+    int col = field_index(field);
+    string binName = filename;
+    if (binName.find('.') > binName.size())
+        binName += ".bin";
 
+    string order = filename + "." + field + (descending ? " desc" : "");
+    PlanStep loading;
+    unique_ptr<Operator> rows;
+    if (RPN.empty())
+    {
+        load_index(col, &loading);
+        rows.reset(new IndexOrder(binName, indices[col], descending,
+                                  recordCount));
+        rows->set_label("index order on " + order);
+        found_by_all(*rows, loading);
+        return rows;
+    }
+
+    // walking the index touches about wanted / found of the table's
+    // postings before it has enough rows, sorting reads every record
+    // found. walk it unless that is more than 8 postings a record
+    PlanStep how;
+    vector<int> found = find_recnos(RPN, &how);
+    long foundCount = static_cast<long>(found.size());
+    long walked = recordCount;
+    if (wanted >= 0 && foundCount > 0)
+        walked = static_cast<long>(min<long long>(
+            walked, static_cast<long long>(wanted) * recordCount / foundCount));
+    if (foundCount * 8 >= walked)
+    {
+        load_index(col, &loading);
+        rows.reset(new IndexOrder(binName, indices[col], descending,
+                                  foundCount, RecnoSet(found, recordCount)));
+        rows->set_label("index order on " + order);
+    }
+    else
+    {
+        rows.reset(new Sort(binName, found, col, types[col], descending,
+                            sortBudget, wanted));
+        rows->set_label("sort on " + order);
+    }
+    rows->found_by(std::move(how));
+    found_by_all(*rows, loading);
+    return rows;
+}
+
+// an index nested loop join needs the inner index in memory. loading
+// it means reading its whole index file, so if it is not loaded yet
+// the inner records are hashed instead
+unique_ptr<Operator> Table::join(Table &inner, const string &field,
+                                 const string &innerField,
+                                 const vector<string> &RPN,
+                                 const vector<string> &innerRPN)
+{
+    int col = field_index(field);
+    int innerCol = inner.field_index(innerField);
+    if (types[col] != inner.types[innerCol])
+        throw error("Invalid Input: join fields must have the same type");
+
+    string binName = filename;
+    if (binName.find('.') > binName.size())
+        binName += ".bin";
+    string innerBin = inner.filename;
+    if (innerBin.find('.') > innerBin.size())
+        innerBin += ".bin";
+
+    vector<string> names;
+    for (size_t i = 0; i < fieldList.size(); ++i)
+        names.push_back(filename + "." + fieldList[i]);
+    for (size_t i = 0; i < inner.fieldList.size(); ++i)
+        names.push_back(inner.filename + "." + inner.fieldList[i]);
+
+    unique_ptr<Operator> rows = RPN.empty() ? select_all() : select_all(RPN);
+    // every outer row joins the average rows of a key of the inner field
+    long estimate = -1;
+    if (inner.stats.exists() && rows->size() >= 0)
+        estimate = static_cast<long>(
+            static_cast<double>(rows->size()) * inner.stats.row_count() /
+                max(1L, inner.stats.column(innerCol).distinct) +
+            0.5);
+    if (inner.loaded[innerCol])
+    {
+        RecnoSet keep;
+        PlanStep how;
+        if (!innerRPN.empty())
+            keep = RecnoSet(inner.find_recnos(innerRPN, &how),
+                            inner.recordCount);
+        unique_ptr<Operator> joined(new IndexJoin(
+            binName, std::move(rows), col, types[col], innerBin,
+            inner.indices[innerCol], innerRPN.empty() ? NULL : &keep, names,
+            "index nested loop join on " + inner.filename + "." + innerField));
+        if (!innerRPN.empty())
+            joined->found_by(std::move(how));
+        joined->set_estimate(estimate);
+        return joined;
+    }
+    unique_ptr<Operator> innerRows = innerRPN.empty()
+                                         ? inner.select_all()
+                                         : inner.select_all(innerRPN);
+    unique_ptr<Operator> joined(new HashJoin(
+        binName, std::move(rows), col, innerBin, std::move(innerRows),
+        innerCol, types[col], names,
+        "hash join on " + inner.filename + "." + innerField));
+    joined->set_estimate(estimate);
+    return joined;
+}
+
+// counts, and the min and max of a field, are in the indices already:
+// the size of a posting list and the first and last key. those are
+// answered without reading a record, anything else is worked out by
+// an Aggregate over the records found
+unique_ptr<Operator> Table::aggregate(const vector<string> &RPN,
+                                      const vector<string> &columns,
+                                      const string &group, bool descending)
+{
+    // count(*) -> (COUNT, -1), sum(salary) -> (SUM, salary), the group
+    // field -> (GROUP_FIELD, group)
+    vector<AggregateColumn> specs;
+    bool counts = true;
+    bool ends = true;
+    for (size_t i = 0; i < columns.size(); ++i)
+    {
+        AggregateColumn c;
+        size_t paren = columns[i].find('(');
+        if (paren == string::npos)
+        {
+            if (columns[i] != group)
+                throw error("Invalid Input: only the group by field can be selected with aggregates");
+            c.function = GROUP_FIELD;
+            c.col = field_index(group);
+        }
+        else
+        {
+            string arg = columns[i].substr(paren + 1,
+                                           columns[i].size() - paren - 2);
+            c.function = aggregate_function(columns[i].substr(0, paren));
+            if (arg == "*" && c.function != COUNT)
+                throw error("Invalid Input: only count takes *");
+            c.col = arg == "*" ? -1 : field_index(arg);
+        }
+        counts = counts && (c.function == COUNT || c.function == GROUP_FIELD);
+        ends = ends && (c.function == COUNT || c.function == MIN ||
+                        c.function == MAX);
+        specs.push_back(c);
+    }
+
+    // select count(*), min(age), max(age) from student [where ...]
+    PlanStep how;
+    if (group.empty() && (RPN.empty() ? ends : counts))
+    {
+        long count = RPN.empty()
+                         ? recordCount
+                         : static_cast<long>(find_recnos(RPN, &how).size());
+        PlanStep loading;
+        vector<string> row;
+        for (size_t i = 0; i < specs.size(); ++i)
+        {
+            if (specs[i].function == COUNT)
+            {
+                row.push_back(to_string(count));
+                continue;
+            }
+            int col = specs[i].col;
+            load_index(col, &loading);
+            MMap<string, int> &index = indices[col];
+            if (index.empty())
+                row.push_back(string());
+            else if (specs[i].function == MIN)
+                row.push_back(column_value(types[col], index.begin()->key));
+            else
+                row.push_back(column_value(types[col], index.rbegin()->key));
+        }
+        unique_ptr<Operator> rows(
+            new Values(columns, vector<vector<string>>(1, row)));
+        rows->set_label(RPN.empty()
+                            ? "aggregate from the record count and index ends"
+                            : "count of the records found");
+        if (!RPN.empty())
+            rows->found_by(std::move(how));
+        found_by_all(*rows, loading);
+        return rows;
+    }
+
+    // select lname, count(*) from student group by lname
+    if (!group.empty() && RPN.empty() && counts)
+    {
+        int col = field_index(group);
+        PlanStep loading;
+        load_index(col, &loading);
+        vector<vector<string>> rows;
+        vector<string> row(specs.size());
+        auto add = [&](const MPair<string, int> &entry)
+        {
+            for (size_t i = 0; i < specs.size(); ++i)
+                row[i] = specs[i].function == COUNT
+                             ? to_string(entry.value_list.size())
+                             : column_value(types[col], entry.key);
+            rows.push_back(row);
+        };
+        MMap<string, int> &index = indices[col];
+        if (index.empty())
+            ;
+        else if (descending)
+            for (auto it = index.rbegin(); it != index.rend(); ++it)
+                add(*it);
+        else
+            for (auto it = index.begin(); it != index.end(); ++it)
+                add(*it);
+        unique_ptr<Operator> counted(new Values(columns, rows));
+        counted->set_label("count of each key of the index on " + filename +
+                           "." + group);
+        found_by_all(*counted, loading);
+        return counted;
+    }
+
+    unique_ptr<Operator> rows = RPN.empty() ? select_all() : select_all(RPN);
+    int groupCol = group.empty() ? -1 : field_index(group);
+    // a group for each distinct key, as many as there are rows at most
+    long estimate = -1;
+    if (groupCol >= 0 && stats.exists())
+        estimate = rows->size() < 0
+                       ? stats.column(groupCol).distinct
+                       : min(stats.column(groupCol).distinct, rows->size());
+    unique_ptr<Operator> grouped(new Aggregate(std::move(rows), specs,
+                                               groupCol, types, columns,
+                                               descending));
+    grouped->set_estimate(estimate);
+    return grouped;
+}
+
+// replaces the last two steps with step, the and/or of them. the
+// statistics guess the result as if the two were independent
+void Table::combine_steps(vector<PlanStep> &steps, const string &op,
+                          long rows, PlanStep &step)
+{
+    PlanStep right = std::move(steps.back());
+    steps.pop_back();
+    PlanStep left = std::move(steps.back());
+    steps.pop_back();
+
+    step.what = op == "and" ? "and (bitmap intersection)"
+                            : "or (bitmap union)";
+    step.rows = step.planned = rows;
+    step.ms += left.ms + right.ms;
+    double total = static_cast<double>(stats.row_count());
+    if (left.estimate >= 0 && right.estimate >= 0 && total > 0)
+    {
+        double both = left.estimate * (right.estimate / total);
+        step.estimate = static_cast<long>(
+            (op == "and" ? both : left.estimate + right.estimate - both) +
+            0.5);
+    }
+    step.inputs.push_back(std::move(left));
+    step.inputs.push_back(std::move(right));
+    steps.push_back(std::move(step));
+}
+
+// Evalutes "RPN" against the indices and returns the numbers of the
+// records that were found. and/or combine the results as bitmaps of
+// the record numbers
+vector<int> Table::find_recnos(const vector<string> &RPN, PlanStep *how)
+{
     string first;
     string second;
-    vector<vector<int>> recordnums;
+    vector<RecnoSet> recordnums;
     vector<int> rn;
-    vector<int> RFirst;
-    vector<int> RSecond;
-    vector<Record> records;
-    Table tempT(name, fieldList);
     vector<string> operandStack;
+    // true once an and/or has combined two results
+    bool combined = false;
+    // how each set on recordnums was found, if how is wanted
+    vector<PlanStep> steps;
 
     for (size_t i = 0; i < RPN.size(); ++i)
     {
+        // a range fused from two predicates (see Parser::fuseRanges)
+        bool range = RPN[i] == "[]" || RPN[i] == "[)" || RPN[i] == "(]" || RPN[i] == "()";
+
         // operands
-        if (RPN[i] != "=" && RPN[i] != ">" && RPN[i] != "<" && RPN[i] != "<=" && RPN[i] != ">=" && RPN[i] != "and" && RPN[i] != "or")
+        if (!range && RPN[i] != "=" && RPN[i] != ">" && RPN[i] != "<" && RPN[i] != "<=" && RPN[i] != ">=" && RPN[i] != "and" && RPN[i] != "or")
         {
             operandStack.push_back(RPN[i]);
         }
         // operators
         else
         {
-            if (RPN[i] == "=")
+            if (RPN[i] == "=" || RPN[i] == ">" || RPN[i] == "<" || RPN[i] == "<=" || RPN[i] == ">=")
             {
                 // pop first two operands
-                // do the operations->get record numebrs->push
-                // into record numbers vector
+                // do the operations->get record numbers->push
+                // the set of them onto the record numbers stack
                 first = operandStack.back();
                 operandStack.pop_back();
                 second = operandStack.back();
                 operandStack.pop_back();
-                rn = get_recno_of(second, "=", first);
-                recordnums.push_back(rn);
+                PlanStep step;
+                {
+                    Timer timer(step.ms);
+                    rn = get_recno_of(second, RPN[i], first,
+                                      how ? &step : NULL);
+                    recordnums.push_back(RecnoSet(rn, recordCount));
+                }
+                if (how)
+                {
+                    step.rows = step.planned = recordnums.back().size();
+                    steps.push_back(std::move(step));
+                }
             }
-            else if (RPN[i] == ">" || RPN[i] == "<" || RPN[i] == "<=" || RPN[i] == ">=")
+            else if (range)
             {
-                // pop first two operands
-                // do the operations->get record numebers->push
-                // into record numbers vector
-                first = operandStack.back();
+                // pop high, low and the field, then scan the index
+                // once from low to high
+                string high = operandStack.back();
                 operandStack.pop_back();
-                second = operandStack.back();
+                string low = operandStack.back();
                 operandStack.pop_back();
-                rn = get_recno_of(second, RPN[i], first);
-                recordnums.push_back(rn);
+                string field = operandStack.back();
+                operandStack.pop_back();
+                PlanStep step;
+                {
+                    Timer timer(step.ms);
+                    rn = get_recno_in(field, RPN[i], low, high,
+                                      how ? &step : NULL);
+                    recordnums.push_back(RecnoSet(rn, recordCount));
+                }
+                if (how)
+                {
+                    step.rows = step.planned = recordnums.back().size();
+                    steps.push_back(std::move(step));
+                }
+                // it stands for an and, so it comes out like one
+                combined = true;
             }
             // if we get and or or we need to do union or intersection
             else if (RPN[i] == "and" || RPN[i] == "or")
             {
-                // pop last two vector of records
-                RFirst = recordnums.back();
-                recordnums.pop_back();
-                RSecond = recordnums.back();
-                recordnums.pop_back();
-                // do set intersection or union on these vectors
-                // and push the result back into the recordnumbers
-                // vector
-                if (RPN[i] == "and")
+                // pop the last set and combine it into the one
+                // under it, which stays on the stack as the result
+                PlanStep step;
                 {
-                    // intersection
-                    rn = intersection(RSecond, RFirst);
-                    recordnums.push_back(rn);
-                }
-                else if (RPN[i] == "or")
-                {
-                    rn = VUnion(RSecond, RFirst);
-                    recordnums.push_back(rn);
+                    Timer timer(step.ms);
+                    RecnoSet RFirst = std::move(recordnums.back());
+                    recordnums.pop_back();
+                    if (RPN[i] == "and")
+                        recordnums.back() &= RFirst;
+                    else
+                        recordnums.back() |= RFirst;
                 }
+                combined = true;
+                if (how)
+                    combine_steps(steps, RPN[i], recordnums.back().size(),
+                                  step);
             }
         }
     }
 
-    // sort to keep in order that they appear in table
-    // VSort(recordnums.back());
-    // Push back
-    records = get_records(recordnums.back());
-    tempT.fill_table(records);
+    if (how && !steps.empty())
+        *how = std::move(steps.back());
 
-    return tempT;
+    // a single predicate keeps the order its lookup found the records
+    // in, a combined one comes out in record order
+    return combined ? recordnums.back().to_vector() : rn;
+}
+
+// wraps rows so only the named fields are printed. * keeps them all
+unique_ptr<Operator> Table::project(unique_ptr<Operator> rows,
+                                    const vector<string> &names)
+{
+    if (names.empty() || (names.size() == 1 && names[0] == "*"))
+        return rows;
+    string label = "project";
+    for (size_t i = 0; i < names.size(); ++i)
+        label += (i == 0 ? " " : ", ") + names[i];
+    vector<string> fields = rows->names();
+    if (fields.empty())
+    {
+        vector<int> columns;
+        for (size_t i = 0; i < names.size(); ++i)
+            columns.push_back(field_index(names[i]));
+        unique_ptr<Operator> projected(new Project(std::move(rows), columns));
+        projected->set_label(label);
+        return projected;
+    }
+
+    // rows with fields of their own: emp.name, or name if only one of
+    // them is called that
+    vector<int> columns;
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+        int found = -1;
+        int matches = 0;
+        string suffix = "." + names[i];
+        for (size_t j = 0; j < fields.size(); ++j)
+        {
+            if (fields[j] == names[i])
+            {
+                found = static_cast<int>(j);
+                matches = 1;
+                break;
+            }
+            if (fields[j].size() > suffix.size() &&
+                fields[j].compare(fields[j].size() - suffix.size(),
+                                  string::npos, suffix) == 0)
+            {
+                found = static_cast<int>(j);
+                matches++;
+            }
+        }
+        if (matches > 1)
+            throw error("Field is ambiguous");
+        if (found < 0)
+            throw error("Field does not exist");
+        columns.push_back(found);
+    }
+    // already just these fields, in this order (an aggregate)
+    bool same = columns.size() == fields.size();
+    for (size_t i = 0; i < columns.size() && same; ++i)
+        same = columns[i] == static_cast<int>(i);
+    if (same)
+        return rows;
+    unique_ptr<Operator> projected(new Project(std::move(rows), columns));
+    projected->set_label(label);
+    return projected;
 }
 
 // print table like in prompt
 void Table::print_table(ostream &outs)
+{
+    print_rows(outs, *select_all());
+}
+
+// pulls every row out of rows and prints it under the field names
+void Table::print_rows(ostream &outs, Operator &rows)
 {
     const int fieldWidth = 15;
     const char separator = ' ';
 
+    // the fields to print: the ones the rows were cut down to, or
+    // all of them
+    vector<string> names = rows.names();
+    if (names.empty())
+        names = fieldList;
+    vector<int> columns = rows.columns();
+    if (columns.empty())
+        for (size_t i = 0; i < names.size(); ++i)
+            columns.push_back(static_cast<int>(i));
+
     // print field names
     outs << "Table name: " << filename << ", "
-         << "records: " << recordCount << endl;
+         << "records: " << rows.size() << endl;
+    if (!rows.strategy().empty())
+        outs << "Strategy: " << rows.strategy() << endl;
     outs << left << setw(6) << setfill(separator) << "record";
-    for (unsigned int i = 0; i < fieldList.size(); ++i)
+    for (size_t i = 0; i < columns.size(); ++i)
     {
         outs << right << setw(fieldWidth) << setfill(separator)
-             << fieldList[i];
+             << names[columns[i]];
     }
     outs << endl
          << endl;
 
-    // output records
-    fstream f;
-    string binName = filename;
-    if (binName.find('.') > binName.size())
-        binName += ".bin";
-    open_fileRW(f, binName.c_str());
-    Record r;
-    for (int recno = 0; recno < recordCount; ++recno)
+    // output records, numbered in the order they come out. only the
+    // fields that are printed are decoded from the record
+    Row row;
+    for (long n = 0; rows.pull(row); ++n)
     {
-        r.read(f, recno);
-        r.setFieldCount(fieldList.size());
         outs << right << setw(6) << setfill(separator)
-             << recno;
-        outs << r << endl;
+             << n;
+        for (size_t i = 0; i < columns.size(); ++i)
+            outs << right << setw(fieldWidth) << setfill(separator)
+                 << row.record.entry(columns[i]);
+        outs << endl;
     }
-    f.close();
 }
 
 ostream &operator<<(ostream &outs, Table &t)
@@ -286,44 +787,48 @@ ostream &operator<<(ostream &outs, Table &t)
 // use this in select, gets {field op value} and returns
 // the appropriate vector of record numbers
 vector<int> Table::get_recno_of(const string &field,
-                                string op, string val)
+                                string op, string val, PlanStep *how)
 {
-    int row = -1;
-    vector<string> entries;
-    stringstream ss;
+    int row = field_index(field);
     vector<int> recnos;
     vector<int> NE = {};
-    int j = 0;
-    for (size_t i = 0; i < fieldList.size(); ++i)
+    // the index holds keys, val is compared in the field's type
+    string key = index_key(row, val);
+    if (how)
     {
-        // if field is in the field list
-        // return the approp value
-        if (field == fieldList[i])
-        {
-            row = (int)i;
-            break;
-        }
-        // set row to negative 1
-        else
-        {
-            row = -1;
-        }
+        how->what = string(op == "=" ? "index seek" : "index range scan") +
+                    " on " + filename + "." + field + " " + op + " " + val;
+        how->estimate = stats.estimate(row, op, key);
     }
-    // if row is negative one, throw error
-    //(does not exist)
-    if (row == -1)
+
+    // an equality lookup only needs one leaf of an index file that is
+    // up to date, there is no need to load the whole index
+    if (op == "=" && !loaded[row])
     {
-        throw error("Field does not exist");
+        IndexFile idx(index_name(row));
+        if (idx.exists() && idx.record_count() == recordCount)
+        {
+            bool found = idx.find(key, recnos);
+            if (how)
+            {
+                how->what += ", one leaf of " + index_name(row);
+                how->bytes = idx.bytes_read();
+            }
+            if (found)
+                return recnos;
+            cout << "(" << val << " is not found in indices)" << endl;
+            return NE;
+        }
     }
-    else
+    load_index(row, how);
     {
         // equality
         if (op == "=")
         {
             // check if the value is in indices
             // if so return the appropriate records
-            if (indices[row].contains(val))
-                return indices[row][val];
+            if (indices[row].contains(key))
+                return indices[row][key].to_vector();
             // if not, output a message and continue
             else
             {
@@ -331,217 +836,102 @@ vector<int> Table::get_recno_of(const string &field,
                 return NE;
             }
         }
-        // greater than
-        else if (op == ">")
-        {
-            // check if the record is in indices
-            if (indices[row].contains(val))
-            {
-                for (MMap<string, int>::Iterator it =
-                         indices[row].lower_bound(val);
-                     it != indices[row].end(); it++)
-                {
-                    // create a mpair object with val
-                    MPair<string, int> ey(val);
-
-                    // load string stream with recnos
-                    // skipping the first record
-                    if (ey != *it)
-                        ss << *it;
-                }
-                // fill recnos vector with recnos
-                while (ss >> j)
-                {
-                    // make sure j doesn't show up twice
-                    if (!(find(recnos.begin(), recnos.end(), j) != recnos.end()))
-                    {
-                        // push it into our vector
-                        recnos.push_back(j);
-                    }
-                }
-                return recnos;
-            }
-            else
-            {
-                // start at the beginning, go until the end
-                for (MMap<string, int>::Iterator it =
-                         indices[row].begin();
-                     it != indices[row].end(); it++)
-                {
-                    // create an mpair object of val and compare
-                    MPair<string, int> ey(val);
-                    if (*it > ey)
-                    {
-                        ss << *it;
-                    }
-                }
-                while (ss >> j)
-                {
-                    if (!(find(recnos.begin(), recnos.end(), j) != recnos.end()))
-                    {
-                        recnos.push_back(j);
-                    }
-                }
-                return recnos;
-            }
-        }
-        // just like greater than
-        else if (op == "<")
+        // ranges: seek to where the range starts and ends in the
+        // index, then join the posting lists of every key in between
+        else if (op == ">" || op == ">=" || op == "<" || op == "<=")
         {
-            if (indices[row].contains(val))
-            {
-                for (MMap<string, int>::Iterator it =
-                         indices[row].begin();
-                     it != indices[row].upper_bound(val); it++)
-                {
-                    MPair<string, int> ey(val);
-                    // load string stream with recnos
-                    if (ey != *it)
-                        ss << *it;
-                }
-                // fill recnos vector with recnos
-                while (ss >> j)
-                {
-                    if (!(find(recnos.begin(), recnos.end(), j) != recnos.end()))
-                    {
-                        // need to no
-                        recnos.push_back(j);
-                    }
-                }
+            MMap<string, int> &index = indices[row];
+            if (index.empty())
                 return recnos;
-            }
+            MMap<string, int>::Iterator from = index.begin();
+            MMap<string, int>::Iterator to = index.end();
+            if (op == ">")
+                from = index.upper_bound(key);
+            else if (op == ">=")
+                from = index.lower_bound(key);
+            else if (op == "<")
+                to = index.lower_bound(key);
             else
-            {
-                // start at the beginning, go until the end
-                for (MMap<string, int>::Iterator it =
-                         indices[row].begin();
-                     it != indices[row].end(); it++)
-                {
-                    // create an mpair object of val and compare
-                    MPair<string, int> ey(val);
-                    if (*it < ey)
-                    {
-                        ss << *it;
-                    }
-                }
-                while (ss >> j)
-                {
-                    if (!(find(recnos.begin(), recnos.end(), j) != recnos.end()))
-                    {
-                        recnos.push_back(j);
-                    }
-                }
-                return recnos;
-            }
-        }
-        // just like greater than
-        else if (op == ">=")
-        {
-            // don't skip the first element this time
-            if (indices[row].contains(val))
-            {
-                for (MMap<string, int>::Iterator it =
-                         indices[row].lower_bound(val);
-                     it != indices[row].end(); it++)
-                {
-                    // load string stream with recnos
-                    ss << *it;
-                }
-                // fill recnos vector with recnos
-                while (ss >> j)
-                {
-                    if (!(find(recnos.begin(), recnos.end(), j) != recnos.end()))
-                    {
-                        recnos.push_back(j);
-                    }
-                }
-                return recnos;
-            }
-            else
-            {
-                // start at the beginning, go until the end
-                for (MMap<string, int>::Iterator it =
-                         indices[row].begin();
-                     it != indices[row].end(); it++)
-                {
-                    // create an mpair object of val and compare
-                    MPair<string, int> ey(val);
-                    if (*it > ey)
-                    {
-                        ss << *it;
-                    }
-                }
-                while (ss >> j)
-                {
-                    if (!(find(recnos.begin(), recnos.end(), j) != recnos.end()))
-                    {
-                        recnos.push_back(j);
-                    }
-                }
-                return recnos;
-            }
-        }
-        // just like <
-        else if (op == "<=")
-        {
-            if (indices[row].contains(val))
-            {
-                for (MMap<string, int>::Iterator it =
-                         indices[row].begin();
-                     it != indices[row].upper_bound(val); it++)
-                {
-                    // load string stream with recnos
-                    ss << *it;
-                }
-                // fill recnos vector with recnos
-                while (ss >> j)
-                {
-                    if (!(find(recnos.begin(), recnos.end(), j) != recnos.end()))
-                    {
-                        recnos.push_back(j);
-                    }
-                }
-                return recnos;
-            }
-            else
-            {
-                // start at the beginning, go until the end
-                for (MMap<string, int>::Iterator it =
-                         indices[row].begin();
-                     it != indices[row].end(); it++)
-                {
-                    // create an mpair object of val and compare
-                    MPair<string, int> ey(val);
-                    if (*it < ey)
-                    {
-                        ss << *it;
-                    }
-                }
-                while (ss >> j)
-                {
-                    if (!(find(recnos.begin(), recnos.end(), j) != recnos.end()))
-                    {
-                        recnos.push_back(j);
-                    }
-                }
-                return recnos;
-            }
+                to = index.upper_bound(key);
+            return join_postings(from, to);
         }
     }
     return NE;
 }
 
+// gets {field low high bounds} of a fused range and returns the record
+// numbers of the keys between low and high, seeking the index once for
+// each end
+vector<int> Table::get_recno_in(const string &field, const string &bounds,
+                                const string &low, const string &high,
+                                PlanStep *how)
+{
+    int row = field_index(field);
+    string lowKey = index_key(row, low);
+    string highKey = index_key(row, high);
+    if (how)
+    {
+        how->what = "index range scan on " + filename + "." + field +
+                    " in " + bounds[0] + low + ", " + high + bounds[1];
+        // the rows above low and the rows below high overlap in the
+        // range, everything else is counted once
+        long above = stats.estimate(row, bounds[0] == '[' ? ">=" : ">",
+                                    lowKey);
+        long below = stats.estimate(row, bounds[1] == ']' ? "<=" : "<",
+                                    highKey);
+        if (above >= 0 && below >= 0)
+            how->estimate = max(0L, above + below - stats.row_count());
+    }
+    load_index(row, how);
+
+    // an empty range would have its end before its start
+    MMap<string, int> &index = indices[row];
+    if (index.empty() || lowKey > highKey ||
+        (lowKey == highKey && bounds != "[]"))
+        return vector<int>();
+
+    MMap<string, int>::Iterator from = bounds[0] == '['
+                                           ? index.lower_bound(lowKey)
+                                           : index.upper_bound(lowKey);
+    MMap<string, int>::Iterator to = bounds[1] == ']'
+                                         ? index.upper_bound(highKey)
+                                         : index.lower_bound(highKey);
+    return join_postings(from, to);
+}
+
+// the record numbers of every key from from up to (not including) to,
+// in key order
+vector<int> Table::join_postings(MMap<string, int>::Iterator from,
+                                 MMap<string, int>::Iterator to)
+{
+    vector<int> recnos;
+    for (MMap<string, int>::Iterator it = from; it != to; ++it)
+        for (int recno : it->value_list)
+            recnos.push_back(recno);
+    return recnos;
+}
+
+// the position of field in the field list, throws if there is no
+// such field
+int Table::field_index(const string &field) const
+{
+    for (size_t i = 0; i < fieldList.size(); ++i)
+        if (field == fieldList[i])
+            return static_cast<int>(i);
+    throw error("Field does not exist");
+}
+
+bool Table::has_field(const string &field) const
+{
+    return find(fieldList.begin(), fieldList.end(), field) != fieldList.end();
+}
+
 // Post: gets field values from a record
-vector<string> Table::get_field_values(Record r)
+vector<string> Table::get_field_values(const Record &r)
 {
     vector<string> fields;
     string temp;
 
-    // not necessary
-    stringstream ss;
-
-    ss << r;
-
     // cheanged to use getEntry
     for (unsigned int i = 0; i < fieldList.size(); ++i)
     {
@@ -553,72 +943,233 @@ vector<string> Table::get_field_values(Record r)
 }
 
 // gets desired records from file
-vector<Record> Table::get_records(vector<int> recnos)
+vector<Record> Table::get_records(const vector<int> &recnos)
 {
-    fstream f;
     string binName = filename;
     if (binName.find('.') > binName.size())
         binName += ".bin";
 
-    open_fileRW(f, binName.c_str());
+    TableReader reader(binName);
 
     vector<Record> records;
+    records.reserve(recnos.size());
 
-    Record r;
     for (size_t i = 0; i < recnos.size(); ++i)
     {
         // if non existant record
         if (recnos[i] == -1)
-        {
-            f.close();
             return records;
-        }
-        r.read(f, recnos[i]);
-        records.push_back(r);
+        records.push_back(Record(reader.view(recnos[i]), recnos[i]));
     }
 
-    f.close();
     return records;
 }
 
-// fills table with records in a vector
-void Table::fill_table(vector<Record> records)
+// loads the index of field col: first from its index file, then
+// from the records written after the index file was saved
+void Table::load_index(int col, PlanStep *how)
 {
-    vector<string> fields;
-    for (size_t i = 0; i < records.size(); ++i)
+    if (loaded[col])
+        return;
+
+    PlanStep step;
+    int covered = 0;
+    {
+        Timer timer(step.ms);
+        IndexFile idx(index_name(col));
+        // an index that covers more records than the table has belongs
+        // to some older table, rebuild it from the b-file instead
+        if (idx.exists() && idx.record_count() <= recordCount)
+        {
+            idx.load(indices[col]);
+            covered = idx.record_count();
+        }
+        saved[col] = covered;
+        step.bytes = idx.bytes_read();
+
+        // replay the tail of the b-file
+        if (covered < recordCount)
+        {
+            string binName = filename;
+            if (binName.find('.') > binName.size())
+                binName += ".bin";
+            TableReader reader(binName, true);
+            vector<pair<string, int>> added;
+            added.reserve(recordCount - covered);
+            for (int recno = covered; recno < recordCount; ++recno)
+                added.push_back(make_pair(
+                    index_key(col, reader.view(recno).entry(col)), recno));
+            merge_index(col, added);
+            step.records = reader.records_read();
+            step.bytes += reader.bytes_read();
+        }
+    }
+    loaded[col] = true;
+
+    if (how)
     {
-        // get field values from record
-        fields = get_field_values(records[i]);
-        // insert into this table
-        insert(fields);
+        string name = filename + "." + fieldList[col];
+        if (covered == 0)
+            step.what = "build index on " + name + " from the table";
+        else if (covered < recordCount)
+            step.what = "load index on " + name + " from " + index_name(col) +
+                        " and the last " + to_string(recordCount - covered) +
+                        (recordCount - covered == 1 ? " record" : " records");
+        else
+            step.what = "load index on " + name + " from " + index_name(col);
+        step.rows = step.planned = -1;
+        how->inputs.push_back(std::move(step));
     }
 }
 
-// gets a random number to differentiate temp tables
-int Table::getTemp()
+// adds (key, recno) pairs to the index of field col. the pairs are
+// sorted and merged with the entries already in the index, and the
+// index is rebuilt bottom up from the result
+void Table::merge_index(int col, vector<pair<string, int>> &added)
 {
-    Random rand;
-    return rand.GetNext(0, 200);
+    if (added.empty())
+        return;
+
+    // stable, so the recnos of a key stay in insertion order
+    stable_sort(added.begin(), added.end(),
+                [](const pair<string, int> &a, const pair<string, int> &b)
+                { return a.first < b.first; });
+
+    vector<MPair<string, int>> old;
+    indices[col].flatten(old);
+
+    vector<MPair<string, int>> merged;
+    merged.reserve(old.size() + added.size());
+    size_t i = 0;
+    size_t j = 0;
+    while (i < old.size() || j < added.size())
+    {
+        if (j == added.size() ||
+            (i < old.size() && old[i].key < added[j].first))
+        {
+            merged.push_back(std::move(old[i++]));
+            continue;
+        }
+        // the new recnos of a key come after the ones it already has
+        if (i < old.size() && old[i].key == added[j].first)
+            merged.push_back(std::move(old[i++]));
+        else
+            merged.push_back(MPair<string, int>(added[j].first));
+        PostingList &recnos = merged.back().value_list;
+        const string &key = merged.back().key;
+        while (j < added.size() && added[j].first == key)
+            recnos.push_back(added[j++].second);
+        recnos.shrink_to_fit();
+    }
+    indices[col].build(merged);
 }
 
-// cleans the table function
-void Table::clean_up()
+// writes the loaded indices whose index files are behind the table
+void Table::save_indices()
 {
     for (size_t i = 0; i < indices.size(); ++i)
-        indices[i].clearMap();
+    {
+        if (loaded[i] && saved[i] != recordCount)
+        {
+            IndexFile::save(index_name(i), indices[i], recordCount);
+            saved[i] = recordCount;
+        }
+    }
+}
 
-    // remove temp file and txt files
-    string binName = filename;
-    if (binName.find('.') > binName.size())
-        binName += ".bin";
-    remove(binName.c_str());
+void Table::analyze()
+{
+    for (size_t i = 0; i < fieldList.size(); ++i)
+        load_index(i);
+    stats.analyze(indices, recordCount);
+    save_stats();
+}
+
+unique_ptr<Operator> Table::statistics()
+{
+    if (!stats.exists())
+        throw error("Table has not been analyzed");
+    vector<string> names = {"field", "type", "distinct", "min", "max",
+                            "buckets"};
+    vector<vector<string>> rows;
+    for (size_t i = 0; i < fieldList.size(); ++i)
+    {
+        const ColumnStats &c = stats.column(i);
+        bool empty = c.counts.empty();
+        rows.push_back({fieldList[i], column_type_name(types[i]),
+                        to_string(c.distinct),
+                        empty ? string() : column_value(types[i], c.min),
+                        empty ? string() : column_value(types[i], c.max),
+                        to_string(c.bounds.size())});
+    }
+    unique_ptr<Operator> values(new Values(names, rows));
+    values->set_label("statistics of " + filename);
+    return values;
+}
 
-    string txtName = filename;
-    txtName += "_fields.txt";
-    remove(txtName.c_str());
+long Table::estimate(const string &field, const string &op,
+                     const string &value)
+{
+    int col = field_index(field);
+    return stats.estimate(col, op, index_key(col, value));
+}
+
+void Table::save_stats()
+{
+    stats.save(stats_name());
+}
+
+// the stats file is table_stats.txt, next to table_fields.txt
+string Table::stats_name() const
+{
+    return filename + "_stats.txt";
+}
+
+// index files are named table_field.idx
+string Table::index_name(int col)
+{
+    return filename + "_" + fieldList[col] + ".idx";
 }
 
-// saves a record to the b-file
+// typed fields are indexed by keys that sort in value order (see
+// column.h), string fields by their text
+string Table::index_key(int col, string_view value) const
+{
+    return column_key(types[col], value);
+}
+
+// splits one line of a load file into its values. values are
+// separated by commas, blanks and double quotes around them are dropped
+vector<string> Table::split_values(const string &line)
+{
+    vector<string> values;
+    if (line.find_first_not_of(" \t\r") == string::npos)
+        return values;
+
+    size_t start = 0;
+    while (true)
+    {
+        size_t end = line.find(',', start);
+        string value = line.substr(start, end == string::npos
+                                              ? string::npos
+                                              : end - start);
+        size_t first = value.find_first_not_of(" \t\r");
+        size_t last = value.find_last_not_of(" \t\r");
+        value = first == string::npos
+                    ? ""
+                    : value.substr(first, last - first + 1);
+        if (value.size() >= 2 && value.front() == '"' && value.back() == '"')
+            value = value.substr(1, value.size() - 2);
+        values.push_back(value);
+        if (end == string::npos)
+            break;
+        start = end + 1;
+    }
+    return values;
+}
+
+// saves a record to the b-file. throws if it could not be written, so
+// the caller does not index a record that is not there
 void Table::save_list(Record &list)
 {
     fstream f;
@@ -630,28 +1181,14 @@ void Table::save_list(Record &list)
         binName += ".bin";
     }
 
-    try
-    {
-        // Open file in read/write and binary mode
-        open_fileRW(f, binName.c_str());
+    // Open file in read/write and binary mode
+    open_fileRW(f, binName.c_str());
 
-        // Write the record and set its record number
-        int Recno = list.write(f);
-        list.setRecno(Recno);
-    }
-    catch (const exception &e)
-    {
-        cerr << "Error in save_list: " << e.what() << endl;
-        // Handle cleanup or rethrow if needed
-    }
-    catch (...)
-    {
-        cerr << "Unknown error in save_list." << endl;
-    }
+    // Write the record and set its record number
+    int Recno = list.write(f);
+    list.setRecno(Recno);
 
-    // Close file safely
-    if (f.is_open())
-    {
-        f.close();
-    }
+    f.close();
+    if (f.fail())
+        throw error("Could not write table file");
 }
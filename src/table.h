@@ -4,7 +4,13 @@
 #include "map.h"
 #include "mmap.h"
 #include "record.h"
+#include "index_file.h"
+#include "table_stats.h"
+#include "recno_set.h"
+#include "column.h"
+#include "executor.h"
 #include "error.h"
+#include <memory>
 
 
 
@@ -20,8 +26,17 @@ public:
 */
     //loads existing table
     Table(string name);
-    //creates table with name and field list
-    Table(string name, vector<string> field_list);
+    //creates table with name and field list. type_list holds the
+    //type of each field ("int", "double", "string" or "date"),
+    //fields past its end are strings
+    Table(string name, vector<string> field_list,
+          vector<string> type_list = vector<string>());
+
+    //moving a table hands its indices over instead of copying them
+    Table(Table&& other) = default;
+    Table& operator =(Table&& other) = default;
+    Table(const Table& other) = default;
+    Table& operator =(const Table& other) = default;
 
 /*
  * *************************************************************
@@ -31,14 +46,62 @@ public:
     //inserts values into table
     void insert(const vector<string> field_values);
 
-    //Returns all records from table as a temp table
+    //inserts many rows with a single append to the b-file and one
+    //rebuild of every loaded index
+    void insert_many(const vector<vector<string>>& rows);
+
+    //inserts every line of the file called file_name as a row, values
+    //separated by commas. returns the number of rows inserted
+    int load(const string& file_name);
+
+    //Returns a scan of all records from table
     //e.g Select * from student
-    Table select_all();
+    unique_ptr<Operator> select_all();
 
-    //Evaluates an RPN expression, and return valid records
-    //from table as a temp table
+    //Evaluates an RPN expression, and returns a lookup of the valid
+    //records from table
     //e.g select * from student where lname = Jo and fname = Bob
-    Table select_all(vector<string> RPN);
+    unique_ptr<Operator> select_all(vector<string> RPN);
+
+    //the records found by RPN (every record if RPN is empty) in the
+    //order of field, largest first if descending. if wanted is not
+    //negative only the first wanted rows will be pulled
+    //e.g select * from student where age > 20 order by lname desc
+    unique_ptr<Operator> select_ordered(const vector<string>& RPN,
+                                        const string& field,
+                                        bool descending,
+                                        long wanted = -1);
+
+    //the aggregate columns (count(*), sum(salary), ... and the group
+    //field itself) of the records found by RPN, one row per value of
+    //field group, or a single row if group is empty. the groups come
+    //in the order of group, largest first if descending
+    //e.g select dept, count(*), avg(salary) from staff group by dept
+    unique_ptr<Operator> aggregate(const vector<string>& RPN,
+                                   const vector<string>& columns,
+                                   const string& group, bool descending);
+
+    //the records of this table (the ones RPN finds, all of them if it
+    //is empty) joined to the records of inner (the ones innerRPN finds)
+    //whose innerField equals field. the inner records are looked up in
+    //the index of innerField if it is loaded, or hashed on it if not.
+    //the fields of a joined row are called table.field
+    //e.g select * from emp join dept on emp.dept = dept.name
+    unique_ptr<Operator> join(Table& inner, const string& field,
+                              const string& innerField,
+                              const vector<string>& RPN,
+                              const vector<string>& innerRPN);
+
+    //sets the bytes of sort keys an order by may hold in memory
+    //before it spills sorted runs to disk
+    void set_sort_budget(size_t bytes){sortBudget = bytes;}
+
+    //cuts the rows down to the fields called names, "*" is every field.
+    //a field of rows that have names of their own (a join) can also be
+    //called by its name without the table, if that is unambiguous
+    //e.g select lname, age from student
+    unique_ptr<Operator> project(unique_ptr<Operator> rows,
+                                 const vector<string>& names);
 
 /*
  * *************************************************************
@@ -47,6 +110,8 @@ public:
 */
     //prints a nice table in the way that was demonstracted
     void print_table(ostream& outs);
+    //prints the rows of a select, pulling them one at a time
+    void print_rows(ostream& outs, Operator& rows);
     friend ostream& operator <<(ostream& outs, Table&t);
 
 
@@ -58,51 +123,128 @@ public:
     //saves a record to the b-file
     void save_list(Record& list);
 
+    //reads the index of field col from its index file, then adds the
+    //records appended since the file was written. does nothing if the
+    //index is already loaded. if how is not NULL a step telling how
+    //the index was loaded is added to its inputs
+    void load_index(int col, PlanStep* how = NULL);
+
+    //writes every loaded index that is newer than its index file
+    void save_indices();
+
+    //walks every index and records the statistics of each field in
+    //the stats file (see TableStats)
+    //e.g analyze student
+    void analyze();
+
+    //the statistics of each field, one row per field
+    unique_ptr<Operator> statistics();
+
+    //estimated number of records whose field is op value, -1 if the
+    //table has not been analyzed
+    long estimate(const string& field, const string& op,
+                  const string& value);
+
+    //writes the statistics if they changed since the stats file was
+    //written
+    void save_stats();
+
+    //name of the stats file
+    string stats_name() const;
+
+    //name of the index file for field col
+    string index_name(int col);
+
+    //adds (key, recno) pairs to the index of field col, rebuilding it
+    //bottom up
+    void merge_index(int col, vector<pair<string, int>>& added);
+
 /*
  * *************************************************************
  *     A C C E S O R    A N D   E X T R A   F U N C T I O N S
  * *************************************************************
 */
-    //return vector of record numbers that satisfy the values given
-    vector<int> get_recno_of(const string & field, string op, string val);
+    //returns the record numbers RPN finds. if how is not NULL it is
+    //set to the lookups and and/or's that found them, for explain
+    vector<int> find_recnos(const vector<string>& RPN,
+                            PlanStep* how = NULL);
+
+    //return vector of record numbers that satisfy the values given.
+    //if how is not NULL it is told how the index was searched
+    vector<int> get_recno_of(const string & field, string op, string val,
+                             PlanStep* how = NULL);
+
+    //return vector of record numbers whose field is between low and
+    //high. bounds is [] [) (] or (), a bracket includes its end
+    vector<int> get_recno_in(const string& field, const string& bounds,
+                             const string& low, const string& high,
+                             PlanStep* how = NULL);
+
+    //the record numbers of the keys of an index from from up to to
+    vector<int> join_postings(MMap<string, int>::Iterator from,
+                              MMap<string, int>::Iterator to);
+
+    //the position of field in the field list
+    int field_index(const string& field) const;
+
+    //true if the table has a field called field
+    bool has_field(const string& field) const;
 
     //returns vector of records that match the record numbers given
-    vector<Record> get_records(vector<int> recnos);
+    vector<Record> get_records(const vector<int>& recnos);
 
     //gets field values from record
-    vector<string> get_field_values(Record r);
+    vector<string> get_field_values(const Record& r);
 
-    //fills a table with a given vector of records
-    void fill_table(vector<Record> records);
+    //the index key of value in field col, throws if value is not of
+    //the field's type
+    string index_key(int col, string_view value) const;
 
-    //gets a random number to add to temp table name
-    int getTemp();
+    //splits a line of a load file into its values
+    static vector<string> split_values(const string& line);
 
     //gets the name of the table
     string getName(){return filename;}
 
-    //cleans up temp table data. Deletes all files associated with it
-    void clean_up();
-
 /*
  * *************************************************************
  *              P R I V A T E   V A R I A B L E S
  * *************************************************************
 */
 private:
+    //replaces the last two steps of a where clause with step, their
+    //and/or (op), which found rows records
+    void combine_steps(vector<PlanStep>& steps, const string& op,
+                       long rows, PlanStep& step);
 
     //Vector that holds a mmap of string to record number
     //each mmap symbolizes a field such as lastname, firstname or age
+    //indices are only filled in the first time a field is used
     vector<MMap<string, int>> indices;
 
+    //true once indices[i] has been loaded
+    vector<bool> loaded;
+
+    //number of records covered by each index file on disk
+    vector<int> saved;
+
+    //row counts, distinct counts and histograms made by analyze
+    TableStats stats;
+
     //the fields given to us by a user
     vector<string> fieldList;
 
+    //the type of each field
+    vector<ColumnType> types;
+
     //the name of our table
     string filename;
 
     //how many records in a table
     int recordCount;
+
+    //memory an order by may sort in before it spills to disk
+    size_t sortBudget;
 };
 
 #endif // TABLE_H
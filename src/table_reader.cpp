@@ -0,0 +1,188 @@
+#include "table_reader.h"
+#include "page.h"
+#include <algorithm>
+#include <filesystem>
+#include <map>
+
+#if !defined(__EMSCRIPTEN__) && !defined(_WIN32)
+#define TABLE_READER_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// the page directory of every b-file read, keyed by its absolute path
+static map<string, TableReader::PageDirectory> directories;
+
+static string directory_key(const string &name)
+{
+    return (std::filesystem::current_path() / name).string();
+}
+
+// cleared rather than erased, a reader of the old file may still
+// point at it
+void TableReader::forget(const string &name)
+{
+    directories[directory_key(name)] = PageDirectory();
+}
+
+TableReader::TableReader(const string &name, bool sequential)
+    : base(nullptr), mapSize(0), bufferedPage(-1), recordCount(0),
+      pageCount(0), directory(&directories[directory_key(name)]),
+      lastPage(0), lastFirst(0), lastSlots(0), viewed(0), pagesRead(0),
+      lastRead(-1)
+{
+#ifdef TABLE_READER_MMAP
+    int fd = open(name.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd >= 0 && fstat(fd, &st) == 0 && st.st_size >= TABLE_PAGE_SIZE)
+    {
+        void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED)
+        {
+            base = static_cast<const char *>(p);
+            mapSize = st.st_size;
+            // full scans let the kernel read ahead aggressively
+            if (sequential)
+                madvise(p, mapSize, MADV_SEQUENTIAL);
+        }
+    }
+    // the mapping stays valid after the descriptor is closed
+    if (fd >= 0)
+        close(fd);
+#else
+    (void)sequential;
+#endif
+
+    if (!base)
+    {
+        f.open(name, std::fstream::in | std::fstream::binary);
+        if (f.fail())
+            throw error("Could not open table file");
+    }
+
+    const char *head = page(0);
+    Record::check_header(head);
+    recordCount = get32(head + 20);
+    pageCount = get32(head + 24);
+    // the header does not count as a page of records
+    pagesRead = 0;
+    extend_directory();
+}
+
+TableReader::~TableReader()
+{
+#ifdef TABLE_READER_MMAP
+    if (base)
+        munmap(const_cast<char *>(base), mapSize);
+#endif
+}
+
+// mapped files hand out the page itself, otherwise the page is read
+// into the buffer unless it is already there
+const char *TableReader::page(long n)
+{
+    long pos = n * TABLE_PAGE_SIZE;
+    if (n != lastRead)
+    {
+        pagesRead++;
+        lastRead = n;
+    }
+    if (base)
+    {
+        if (pos + TABLE_PAGE_SIZE > mapSize)
+            throw error("Table file is corrupt");
+        return base + pos;
+    }
+
+    if (n != bufferedPage)
+    {
+        f.clear();
+        f.seekg(pos, ios_base::beg);
+        f.read(buffer, TABLE_PAGE_SIZE);
+        if (f.gcount() != TABLE_PAGE_SIZE)
+            throw error("Table file is corrupt");
+        bufferedPage = n;
+    }
+    return buffer;
+}
+
+// reads the headers of the pages added since the directory was last
+// extended. the tail pages of a big record start no records, they are
+// left out
+void TableReader::extend_directory()
+{
+    // a file that shrank was made again, its directory is no good
+    if (directory->scanned > pageCount)
+        *directory = PageDirectory();
+
+    char head[8];
+    for (long n = directory->scanned; n < pageCount; ++n)
+    {
+        const char *ph;
+        if (base)
+        {
+            if ((n + 1) * TABLE_PAGE_SIZE > mapSize)
+                throw error("Table file is corrupt");
+            ph = base + n * TABLE_PAGE_SIZE;
+        }
+        else
+        {
+            f.clear();
+            f.seekg(n * TABLE_PAGE_SIZE, ios_base::beg);
+            f.read(head, sizeof(head));
+            if (f.gcount() != sizeof(head))
+                throw error("Table file is corrupt");
+            ph = head;
+        }
+        if (get16(ph + 4) == 0)
+            continue;
+        directory->firsts.push_back(get32(ph));
+        directory->pages.push_back(n);
+    }
+    directory->scanned = max(directory->scanned, pageCount);
+}
+
+// finds the page of recno, then points at the record in its slot
+RecordView TableReader::view(long recno)
+{
+    if (recno < 0 || recno >= recordCount)
+        return RecordView();
+
+    if (lastPage == 0 || recno < lastFirst || recno >= lastFirst + lastSlots)
+    {
+        // the last page whose first recno is <= recno. its records run
+        // up to the first recno of the next page, so the page itself
+        // is the only read an index fetch makes
+        const vector<long> &firsts = directory->firsts;
+        size_t i = upper_bound(firsts.begin(), firsts.end(), recno) -
+                   firsts.begin();
+        if (i == 0)
+            throw error("Table file is corrupt");
+        lastPage = directory->pages[i - 1];
+        lastFirst = firsts[i - 1];
+        lastSlots = (i < firsts.size() ? firsts[i] : recordCount) - lastFirst;
+    }
+
+    viewed++;
+    const char *p = page(lastPage);
+    const char *slot = p + TABLE_PAGE_HEADER + TABLE_SLOT * (recno - lastFirst);
+    long off = get32(slot);
+    long len = get32(slot + 4);
+    if (off + len <= TABLE_PAGE_SIZE)
+        return RecordView(p + off, len);
+
+    // big record: gather it from the run of pages
+    long rest = TABLE_PAGE_SIZE - TABLE_PAGE_HEADER;
+    long done = TABLE_PAGE_SIZE - off;
+    jumbo.resize(len);
+    memcpy(&jumbo[0], p + off, done);
+    for (long i = 1; done < len; ++i)
+    {
+        long n = min(rest, len - done);
+        memcpy(&jumbo[done], page(lastPage + i) + TABLE_PAGE_HEADER, n);
+        done += n;
+    }
+    return RecordView(jumbo.data(), len);
+}
@@ -0,0 +1,128 @@
+#ifndef TABLE_READER_H
+#define TABLE_READER_H
+
+#include "mylib.h"
+#include "record.h"
+#include "error.h"
+
+using namespace std;
+
+/*
+ * A TableReader reads records out of a b-file (see record.h for the
+ * layout).
+ *
+ * Where the platform has mmap the whole file is mapped and records are
+ * handed out as views straight into the mapping, so a scan costs no
+ * system call per record. Elsewhere (the Emscripten file system, or if
+ * mapping fails) pages are read through an fstream into a page buffer
+ * and views point into that buffer.
+ *
+ * A view is valid until the next call to view(). The reader sees the
+ * records that were in the file when it was opened.
+ *
+ * The page of a record is found in a directory of the first recno of
+ * every page, kept for each b-file for as long as the program runs. A
+ * b-file only grows, so the directory is only read for the pages added
+ * since it was last used, a page header at a time, and a record is one
+ * page read (or more for a big record) however it is fetched.
+ */
+class TableReader
+{
+public:
+/*
+ * *************************************************************
+ *                    C T O R  /  D T O R
+ * *************************************************************
+*/
+    //opens the b-file called name. sequential tells the reader the
+    //records will be read front to back
+    TableReader(const string& name, bool sequential = false);
+    ~TableReader();
+
+    TableReader(const TableReader&) = delete;
+    TableReader& operator =(const TableReader&) = delete;
+
+    //drops the page directory of the b-file called name, for when the
+    //file is made again from scratch
+    static void forget(const string& name);
+
+/*
+ * *************************************************************
+ *              R E A D    F U N C T I O N S
+ * *************************************************************
+*/
+    //number of records in the file
+    long record_count() const {return recordCount;}
+
+    //record recno, an empty view if there is no such record
+    RecordView view(long recno);
+
+    //true if records come straight out of a mapping of the file
+    bool mapped() const {return base != nullptr;}
+
+    //records handed out by view so far
+    long records_read() const {return viewed;}
+    //bytes of the pages of records read (or touched in the mapping) so
+    //far. a page read again after another one counts again, the page
+    //headers read for the directory do not count
+    long bytes_read() const {return pagesRead * TABLE_PAGE_SIZE;}
+
+    //the first recno of every page that starts records, and the
+    //number of the page
+    struct PageDirectory
+    {
+        vector<long> firsts;
+        vector<long> pages;
+        //pages of the file read into the directory so far
+        long scanned = 1;
+    };
+
+private:
+/*
+ * *************************************************************
+ *            P R I V A T E     F U N C T I O N S
+ * *************************************************************
+*/
+    //page number n of the file, valid until the next call
+    const char* page(long n);
+    //adds the pages of the file the directory does not have yet
+    void extend_directory();
+
+/*
+ * *************************************************************
+ *            P R I V A T E     V A R I A B L E S
+ * *************************************************************
+*/
+    //the mapped file, or nullptr if pages are read through f
+    const char* base;
+    //bytes mapped
+    long mapSize;
+
+    //stream fallback and the page last read from it
+    fstream f;
+    char buffer[TABLE_PAGE_SIZE];
+    long bufferedPage;
+
+    //records and pages in the file when it was opened
+    long recordCount;
+    long pageCount;
+
+    //the page directory of the file, shared by every reader of it
+    PageDirectory* directory;
+
+    //the data page found by the last view, so reading the records of
+    //the same page skips the page search
+    long lastPage;
+    long lastFirst;
+    long lastSlots;
+
+    //a record spread over several pages is copied together here
+    string jumbo;
+
+    //counts for explain analyze, and the page last handed out by page
+    long viewed;
+    long pagesRead;
+    long lastRead;
+};
+
+#endif // TABLE_READER_H
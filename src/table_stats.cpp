@@ -0,0 +1,220 @@
+#include "table_stats.h"
+
+// keys are written as x followed by their bytes in hex, so an empty
+// key or one with blanks in it is still one word of the file
+static string to_hex(const string &key)
+{
+    static const char DIGITS[] = "0123456789abcdef";
+    string hex = "x";
+    for (size_t i = 0; i < key.size(); ++i)
+    {
+        unsigned char c = static_cast<unsigned char>(key[i]);
+        hex += DIGITS[c >> 4];
+        hex += DIGITS[c & 0xf];
+    }
+    return hex;
+}
+
+static bool from_hex(const string &hex, string &key)
+{
+    if (hex.empty() || hex[0] != 'x' || hex.size() % 2 == 0)
+        return false;
+    key.clear();
+    for (size_t i = 1; i < hex.size(); i += 2)
+    {
+        int hi = isdigit(hex[i]) ? hex[i] - '0' : hex[i] - 'a' + 10;
+        int lo = isdigit(hex[i + 1]) ? hex[i + 1] - '0' : hex[i + 1] - 'a' + 10;
+        if (hi < 0 || hi > 15 || lo < 0 || lo > 15)
+            return false;
+        key += static_cast<char>(hi << 4 | lo);
+    }
+    return true;
+}
+
+// the buckets are closed every rows / HISTOGRAM_BUCKETS rows, at the
+// end of a key, so all the rows of a key are in one bucket
+void TableStats::analyze(vector<MMap<string, int>> &indices, long row_count)
+{
+    rows = row_count;
+    columns.assign(indices.size(), ColumnStats());
+    long depth = max(1L, (rows + HISTOGRAM_BUCKETS - 1) / HISTOGRAM_BUCKETS);
+    for (size_t col = 0; col < indices.size(); ++col)
+    {
+        ColumnStats &c = columns[col];
+        long filled = 0;
+        long keys = 0;
+        for (MMap<string, int>::Iterator it = indices[col].begin();
+             it != indices[col].end(); ++it)
+        {
+            if (c.distinct == 0)
+                c.min = it->key;
+            c.max = it->key;
+            c.distinct++;
+            filled += it->value_list.size();
+            keys++;
+            if (filled >= depth)
+            {
+                c.bounds.push_back(it->key);
+                c.counts.push_back(filled);
+                c.keys.push_back(keys);
+                filled = 0;
+                keys = 0;
+            }
+        }
+        if (filled > 0)
+        {
+            c.bounds.push_back(c.max);
+            c.counts.push_back(filled);
+            c.keys.push_back(keys);
+        }
+    }
+    valid = true;
+    dirty = true;
+}
+
+void TableStats::add(const vector<string> &keys, const vector<bool> &fresh)
+{
+    if (!valid)
+        return;
+    rows++;
+    for (size_t col = 0; col < columns.size() && col < keys.size(); ++col)
+    {
+        ColumnStats &c = columns[col];
+        const string &key = keys[col];
+        if (c.counts.empty())
+        {
+            c.distinct = 1;
+            c.min = c.max = key;
+            c.bounds.push_back(key);
+            c.counts.push_back(1);
+            c.keys.push_back(1);
+            continue;
+        }
+        bool added = key < c.min || c.max < key || fresh[col];
+        if (added)
+            c.distinct++;
+        if (key < c.min)
+            c.min = key;
+        if (c.max < key)
+            c.max = key;
+        // past the last bucket: the last bucket grows to take it
+        size_t b = lower_bound(c.bounds.begin(), c.bounds.end(), key) -
+                   c.bounds.begin();
+        if (b == c.bounds.size())
+            c.bounds[--b] = key;
+        c.counts[b]++;
+        if (added)
+            c.keys[b]++;
+    }
+    dirty = true;
+}
+
+double TableStats::rows_below(int col, const string &key,
+                              bool inclusive) const
+{
+    const ColumnStats &c = columns[col];
+    double below = 0;
+    for (size_t b = 0; b < c.bounds.size(); ++b)
+    {
+        if (inclusive ? c.bounds[b] <= key : c.bounds[b] < key)
+        {
+            below += c.counts[b];
+            continue;
+        }
+        const string &low = b == 0 ? c.min : c.bounds[b - 1];
+        if (low < key)
+            below += c.counts[b] / 2.0;
+        break;
+    }
+    return below;
+}
+
+long TableStats::estimate(int col, const string &op, const string &key) const
+{
+    if (!valid || col < 0 || col >= static_cast<int>(columns.size()))
+        return -1;
+    const ColumnStats &c = columns[col];
+    if (rows == 0 || c.distinct == 0)
+        return 0;
+
+    // a key has the average rows of a key of the bucket it falls in
+    double n;
+    if (op == "=")
+    {
+        size_t b = lower_bound(c.bounds.begin(), c.bounds.end(), key) -
+                   c.bounds.begin();
+        n = key < c.min || b == c.bounds.size()
+                ? 0
+                : max(1.0, static_cast<double>(c.counts[b]) /
+                               max(1L, c.keys[b]));
+    }
+    else if (op == "<")
+        n = rows_below(col, key, false);
+    else if (op == "<=")
+        n = rows_below(col, key, true);
+    else if (op == ">")
+        n = rows - rows_below(col, key, true);
+    else if (op == ">=")
+        n = rows - rows_below(col, key, false);
+    else
+        return -1;
+    return min(rows, max(0L, static_cast<long>(n + 0.5)));
+}
+
+// rows n
+// distinct min max buckets bound count keys bound count keys ...
+//                                                      (a column)
+void TableStats::load(const string &name, int column_count)
+{
+    valid = false;
+    dirty = false;
+    columns.clear();
+    ifstream in(name);
+    string word;
+    if (!(in >> word >> rows) || word != "rows")
+        return;
+
+    vector<ColumnStats> read(column_count);
+    for (int col = 0; col < column_count; ++col)
+    {
+        ColumnStats &c = read[col];
+        string min;
+        string max;
+        int buckets;
+        if (!(in >> c.distinct >> min >> max >> buckets) ||
+            !from_hex(min, c.min) || !from_hex(max, c.max) || buckets < 0)
+            return;
+        c.bounds.resize(buckets);
+        c.counts.resize(buckets);
+        c.keys.resize(buckets);
+        for (int b = 0; b < buckets; ++b)
+            if (!(in >> word >> c.counts[b] >> c.keys[b]) ||
+                !from_hex(word, c.bounds[b]))
+                return;
+    }
+    columns.swap(read);
+    valid = true;
+}
+
+void TableStats::save(const string &name)
+{
+    if (!valid || !dirty)
+        return;
+    ofstream out(name, std::ofstream::trunc);
+    if (out.fail())
+        throw error("Could not write stats file");
+    out << "rows " << rows << endl;
+    for (size_t col = 0; col < columns.size(); ++col)
+    {
+        const ColumnStats &c = columns[col];
+        out << c.distinct << " " << to_hex(c.min) << " " << to_hex(c.max)
+            << " " << c.bounds.size();
+        for (size_t b = 0; b < c.bounds.size(); ++b)
+            out << " " << to_hex(c.bounds[b]) << " " << c.counts[b] << " "
+                << c.keys[b];
+        out << endl;
+    }
+    if (out.fail())
+        throw error("Could not write stats file");
+    dirty = false;
+}
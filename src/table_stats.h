@@ -0,0 +1,107 @@
+#ifndef TABLE_STATS_H
+#define TABLE_STATS_H
+
+#include "mylib.h"
+#include "mmap.h"
+#include "error.h"
+
+using namespace std;
+
+//buckets of a column histogram
+const int HISTOGRAM_BUCKETS = 16;
+
+/*
+ * What analyze found out about one column. Keys are index keys (see
+ * column.h), so they compare in the column's order.
+ *
+ * The histogram is equi-depth: bucket b holds the counts[b] rows whose
+ * keys are above bounds[b - 1] (or from min for the first one) up to
+ * and including bounds[b], keys[b] of them distinct. analyze makes the
+ * buckets about the same size; inserts after it add to the bucket
+ * their key falls in.
+ */
+struct ColumnStats
+{
+    ColumnStats(): distinct(0) {}
+
+    //number of distinct keys. exact after analyze, after that a key
+    //is counted as new if it is outside min..max or if the loaded
+    //index did not have it
+    long distinct;
+    string min;
+    string max;
+    vector<string> bounds;
+    vector<long> counts;
+    vector<long> keys;
+};
+
+/*
+ * A TableStats is the statistics catalog of a table: its row count and
+ * a ColumnStats for each field. It is made by analyze and saved as
+ * table_stats.txt next to table_fields.txt, one line per column with
+ * the keys written in hex. Until a table has been analyzed it has no
+ * statistics and the estimates are unknown (-1).
+ */
+class TableStats
+{
+public:
+/*
+ * *************************************************************
+ *                       C T O R S
+ * *************************************************************
+*/
+    TableStats(): rows(0), valid(false), dirty(false) {}
+
+/*
+ * *************************************************************
+ *              R E A D    F U N C T I O N S
+ * *************************************************************
+*/
+    //true once the table has been analyzed
+    bool exists() const {return valid;}
+    long row_count() const {return rows;}
+    const ColumnStats& column(int col) const {return columns[col];}
+
+    //estimated number of rows whose key in column col is op (=, <, >,
+    //<=, >=) key. -1 if there are no statistics
+    long estimate(int col, const string& op, const string& key) const;
+
+/*
+ * *************************************************************
+ *              M O D I F I E R     F U N C T I O N S
+ * *************************************************************
+*/
+    //starts over from the indices of a table of row_count rows, one
+    //per column, walking the leaves of each in key order
+    void analyze(vector<MMap<string, int>>& indices, long row_count);
+
+    //counts a new row with key keys[i] in column i. fresh[i] is true
+    //if the key is known not to have been in the column before
+    void add(const vector<string>& keys, const vector<bool>& fresh);
+
+/*
+ * *************************************************************
+ *               F I L E     F U N C T I O N S
+ * *************************************************************
+*/
+    //reads the stats file called name, for a table of column_count
+    //columns. a missing or unreadable file leaves no statistics
+    void load(const string& name, int column_count);
+
+    //writes the stats file called name if anything changed since it
+    //was read or last written
+    void save(const string& name);
+
+private:
+    //rows of column col whose key is below key, or up to key if
+    //inclusive. a bucket key falls in is counted as half full
+    double rows_below(int col, const string& key, bool inclusive) const;
+
+    long rows;
+    vector<ColumnStats> columns;
+    bool valid;
+    //changed since the file was read or written
+    bool dirty;
+};
+
+#endif // TABLE_STATS_H
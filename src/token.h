@@ -2,11 +2,21 @@
 #define TOKEN_H
 
 #include <string>
+#include <string_view>
 #include <iostream>
 #include <fstream>
 
 using namespace std;
 
+//the types of token the stokenizer makes
+enum token_types {NUMBER_TOKEN = 1, ALPHA_TOKEN, PUNCT_TOKEN, SPACE_TOKEN,
+                  QUOT_TOKEN, UNKNOWN_TOKEN};
+
+/*
+ * A Token is a view of a run of characters in the string the
+ * stokenizer is scanning, and its type. It does not own the characters:
+ * it is good as long as that string is.
+ */
 class Token
 {
 public:
@@ -18,29 +28,36 @@ public:
     //Two argument Constructor
     //Postcondition: the token has been initialized such that str is the
     //string part of the token, and type is the type of this string
-    Token(string str, int type);
+    Token(string_view str, int type): _token(str), _type(type){}
 
     //Postcondition: This will output the token ex. |it|
     friend ostream& operator << (ostream& outs, const Token& t);
 
     //Postcondition: returns the type of the token in int form
-    int type();
+    int type() const {return _type;}
 
     //Postcondition: /this tells you what type the token is
     //ex. ALPHA, NUMBER, SPACE, NUMBER
-    string type_string();
+    string type_string() const;
 
     //Postcondition: returns the string of the token
-    string token_str();
+    string_view token_str() const {return _token;}
+
+    //Postcondition: returns the number of chars in the token
+    size_t length() const {return _token.size();}
 
     //Postcondition: sets the token such that str is the
     //string part of the token, and type is the type of this string
-    void set(string token, int type);
+    void set(string_view token, int type)
+    {
+        _token = token;
+        _type = type;
+    }
 
 private:
 
     //string part of the token
-    string _token;
+    string_view _token;
 
     //type of token
     int _type;
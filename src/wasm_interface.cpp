@@ -28,6 +28,24 @@ string initDatabase() {
     }
 }
 
+// s as a JSON string
+static string json_string(const string& s) {
+    ostringstream out;
+    out << '"';
+    for (char c : s) {
+        if (c == '"' || c == '\\')
+            out << '\\' << c;
+        else if (c == '\n')
+            out << "\\n";
+        else if (static_cast<unsigned char>(c) < 0x20)
+            out << ' ';
+        else
+            out << c;
+    }
+    out << '"';
+    return out.str();
+}
+
 // Execute a single SQL command and return the result as JSON-like string
 string executeCommand(string command) {
     if (globalSQL == nullptr) {
@@ -36,11 +54,11 @@ string executeCommand(string command) {
     
     try {
         // Parse the command
-        Parser p(const_cast<char*>(command.c_str()));
-        MMap<string, string> ptree = p.get_parse_tree();
+        Parser p(command);
+        const Statement& s = p.get_statement();
         
         // Check if parse was successful
-        if (ptree.empty()) {
+        if (s.command == NO_COMMAND) {
             return "{\"error\": \"Invalid SQL syntax\"}";
         }
         
@@ -48,30 +66,63 @@ string executeCommand(string command) {
         result << "{";
         
         // Handle CREATE/MAKE TABLE
-        if (ptree["command"][0] == "create" || ptree["command"][0] == "make") {
-            Table t(ptree["table_name"][0], ptree["fields"]);
+        if (s.command == CREATE_COMMAND) {
+            globalSQL->create_table(s.table, s.fields, s.types);
             result << "\"type\": \"create\", ";
-            result << "\"table\": \"" << ptree["table_name"][0] << "\", ";
+            result << "\"table\": \"" << s.table << "\", ";
             result << "\"message\": \"Table created successfully\"";
         }
         // Handle INSERT
-        else if (ptree["command"][0] == "insert") {
-            Table t(ptree["table_name"][0]);
-            t.insert(ptree["values"]);
+        else if (s.command == INSERT_COMMAND) {
+            globalSQL->open_table(s.table).insert(s.values);
             result << "\"type\": \"insert\", ";
-            result << "\"table\": \"" << ptree["table_name"][0] << "\", ";
+            result << "\"table\": \"" << s.table << "\", ";
             result << "\"message\": \"Record inserted successfully\"";
         }
-        // Handle SELECT
-        else if (ptree["command"][0] == "select") {
-            Table t(ptree["table_name"][0]);
-            Table resultTable = ptree["values"].empty() ? 
-                t.select_all() : 
-                t.select_all(p.shuntingYard());
+        // Handle BULK INSERT
+        else if (s.command == BULK_COMMAND) {
+            int count = globalSQL->bulk_insert(s.table, s.file_name);
+            result << "\"type\": \"insert\", ";
+            result << "\"table\": \"" << s.table << "\", ";
+            result << "\"message\": \"" << count << " records inserted successfully\"";
+        }
+        // Handle SET: set sort budget = <bytes>
+        else if (s.command == SET_COMMAND) {
+            globalSQL->set_option(s);
+            result << "\"type\": \"set\", ";
+            result << "\"message\": \"Sort budget set to "
+                   << s.setting_value << " bytes\"";
+        }
+        // Handle EXPLAIN [ANALYZE] SELECT: the plan as a tree of steps,
+        // and as the text the CLI prints
+        else if (s.command == SELECT_COMMAND && s.explain) {
+            bool analyzed = s.analyze;
+            PlanStep plan = globalSQL->explain(s);
+            ostringstream text;
+            print_plan(text, plan, analyzed);
+            result << "\"type\": \"explain\", ";
+            result << "\"table\": " << json_string(s.table) << ", ";
+            result << "\"analyze\": " << (analyzed ? "true" : "false") << ", ";
+            result << "\"plan\": ";
+            print_plan_json(result, plan);
+            result << ", \"output\": " << json_string(text.str());
+        }
+        // Handle SELECT and ANALYZE, both answer with a table
+        else if (s.command == SELECT_COMMAND ||
+                 s.command == ANALYZE_COMMAND) {
+            Table& t = globalSQL->open_table(s.table);
+            unique_ptr<Operator> rows;
+            if (s.command == ANALYZE_COMMAND) {
+                t.analyze();
+                rows = t.statistics();
+            } else {
+                rows = globalSQL->select_rows(t, s);
+                rows = t.project(std::move(rows), s.columns);
+            }
             
             // Capture table output
             ostringstream tableOutput;
-            resultTable.print_table(tableOutput);
+            t.print_rows(tableOutput, *rows);
             string tableStr = tableOutput.str();
             
             // Parse table name and record count from output
@@ -79,20 +130,13 @@ string executeCommand(string command) {
             size_t recordsPos = tableStr.find("records: ");
             size_t newlinePos = tableStr.find('\n');
             
-            string tableName = resultTable.getName();
-            
-            // Escape quotes in table string for JSON
-            size_t pos = 0;
-            while ((pos = tableStr.find('\"', pos)) != string::npos) {
-                tableStr.replace(pos, 1, "\\\"");
-                pos += 2;
-            }
-            
-            result << "\"type\": \"select\", ";
-            result << "\"table\": \"" << tableName << "\", ";
-            result << "\"output\": \"" << tableStr << "\"";
+            string tableName = t.getName();
             
-            resultTable.clean_up();
+            result << "\"type\": \""
+                   << (s.command == ANALYZE_COMMAND ? "analyze" : "select")
+                   << "\", ";
+            result << "\"table\": " << json_string(tableName) << ", ";
+            result << "\"output\": " << json_string(tableStr);
         }
         else {
             result << "\"error\": \"Unknown command type\"";